@@ -9,7 +9,8 @@ import displaySlice from "../canvas-display/slices/displaySlice";
 import globalSlice from "~/globalSlice";
 import { Separator } from "~/components/ui/separator";
 import { useToast } from "~/hooks/use-toast";
-import { useWorker } from "./context/WorkerContext";
+import { terminateWorker, useWorker } from "./context/WorkerContext";
+import { FlatDecomposition, toNestedDecomposition } from "./types/type";
 
 export default function AlgorithmRunner() {
 	const { isRunning } = useAppSelector((state: RootState) => state.runner);
@@ -29,10 +30,23 @@ export default function AlgorithmRunner() {
 
 	const { toast } = useToast();
 
+	// raised by Stop so the worker returns its best decomposition so far;
+	// needs cross-origin isolation, otherwise Stop terminates the worker
+	const cancelFlagRef = React.useRef<Int32Array | null>(null);
+
 	// terminate worker when the algorithm is aborted
 	const handleeAbortRunCode = () => {
 		if (!workerRef || !workerRef.current) return;
-		workerRef.current.terminate();
+		if (cancelFlagRef.current) {
+			Atomics.store(cancelFlagRef.current, 0, 1);
+			toast({
+				title: "Stopping...",
+				description: "Keeping the best decomposition so far",
+				duration: 2000,
+			});
+			return;
+		}
+		terminateWorker(workerRef);
 		dispatch(runnerSlice.actions.setIsRunning(false));
 		toast({
 			title: "Decomposition Aborted!",
@@ -43,12 +57,6 @@ export default function AlgorithmRunner() {
 	const handleRunCode = (event: React.MouseEvent<HTMLButtonElement>) => {
 		event.stopPropagation();
 		
-		// destroy previous web worker
-		if (workerRef.current) {
-			workerRef.current.terminate();
-			workerRef.current = null;
-		}
-
 		toast({
 			title: "Decomposing...",
 			description: "Might take a while :)",
@@ -63,37 +71,61 @@ export default function AlgorithmRunner() {
 
 		dispatch(runnerSlice.actions.setIsRunning(true));
 
-		const worker = new Worker(
-			new URL("/web-workers/algoWorker.js", import.meta.url),
-			{
+		// the worker and its wasm module outlive a run; only an abort
+		// without cancel flag or an editor change replaces them
+		const worker =
+			workerRef.current ??
+			new Worker(new URL("/web-workers/algoWorker.js", import.meta.url), {
 				type: "module",
-			}
-		);
+			});
 
 		workerRef.current = worker;
 
+		cancelFlagRef.current =
+			typeof SharedArrayBuffer !== "undefined" && crossOriginIsolated
+				? new Int32Array(new SharedArrayBuffer(4))
+				: null;
+
 		worker.postMessage({
 			type: "RUN_TREE_WIDTH",
 			payload: {
 				storedVertices: vertices,
 				storedEdges: edges,
+				cancelFlag: cancelFlagRef.current ?? undefined,
 			},
 		});
 
+		const showDecomposition = (flat: FlatDecomposition) => {
+			const res = toNestedDecomposition(flat);
+			dispatch(displaySlice.actions.setBags(res.bags));
+			dispatch(displaySlice.actions.setEdges(res.edges));
+			dispatch(displaySlice.actions.setNodes());
+			dispatch(displaySlice.actions.flushRawData());
+			// dispatch(runnerSlice.actions.setHasResult(true));
+			dispatch(globalSlice.actions.setHasResult(true));
+		};
+
 		worker.onmessage = function (message) {
+			// anytime result: keep it viewable while the run goes on
+			if (message.data.type === "PROGRESS") {
+				showDecomposition(message.data.payload.res);
+				return;
+			}
+
+			// the module failed to load or the run threw: nothing to show
+			if (message.data.type === "ERROR") {
+				console.error("Worker error:", message.data.payload.message);
+				dispatch(runnerSlice.actions.setIsRunning(false));
+				toast({
+					title: "Failed to decompose.",
+					description: message.data.payload.message,
+				});
+				return;
+			}
+
 			if (message.data.type === "RESULT") {
-				const res: {
-					bags: Array<number[]>;
-					edges: Array<[number, number]>;
-				} = message.data.payload.res;
 				// console.log("res in main thread", res);
-
-				dispatch(displaySlice.actions.setBags(res.bags));
-				dispatch(displaySlice.actions.setEdges(res.edges));
-				dispatch(displaySlice.actions.setNodes());
-				dispatch(displaySlice.actions.flushRawData());
-				// dispatch(runnerSlice.actions.setHasResult(true));
-				dispatch(globalSlice.actions.setHasResult(true));
+				showDecomposition(message.data.payload.res);
 
 				dispatch(globalSlice.actions.setIsInEditMode(false));
 
@@ -114,7 +146,7 @@ export default function AlgorithmRunner() {
 			toast({
 				title: "Failed to decompose.",
 			});
-			worker.terminate();
+			terminateWorker(workerRef);
 		};
 	};
 
@@ -21,3 +21,11 @@ export const useWorker = () => {
 	}
 	return context;
 };
+
+// Stops the decomposition worker, if any, so the next run starts a new one.
+export const terminateWorker = (
+	workerRef: React.MutableRefObject<Worker | null>
+) => {
+	workerRef.current?.terminate();
+	workerRef.current = null;
+};
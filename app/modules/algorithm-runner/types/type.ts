@@ -0,0 +1,39 @@
+// Decomposition as returned by runTreeWidthTyped / runTreeWidthHeap: bag i
+// holds bagMembers[bagOffsets[i] .. bagOffsets[i + 1]), treeEdges lists
+// 1-based bag pairs as (a0, b0, a1, b1, ...). The buffers are transferred
+// from the worker, not copied. The treewidth is between lowerBound and width.
+export type FlatDecomposition = {
+	width: number;
+	lowerBound: number;
+	bagOffsets: Int32Array;
+	bagMembers: Int32Array;
+	treeEdges: Int32Array;
+	interrupted?: boolean;
+	stats?: unknown;
+};
+
+// Shape returned by the original runTreeWidth entry point.
+export type NestedDecomposition = {
+	width: number;
+	lowerBound: number;
+	bags: Array<number[]>;
+	edges: Array<[number, number]>;
+};
+
+export function toNestedDecomposition(
+	res: FlatDecomposition
+): NestedDecomposition {
+	const bags: Array<number[]> = [];
+	for (let i = 0; i + 1 < res.bagOffsets.length; i++) {
+		bags.push(
+			Array.from(
+				res.bagMembers.subarray(res.bagOffsets[i], res.bagOffsets[i + 1])
+			)
+		);
+	}
+	const edges: Array<[number, number]> = [];
+	for (let i = 0; i + 1 < res.treeEdges.length; i += 2) {
+		edges.push([res.treeEdges[i], res.treeEdges[i + 1]]);
+	}
+	return { width: res.width, lowerBound: res.lowerBound, bags, edges };
+}
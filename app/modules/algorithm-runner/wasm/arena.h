@@ -0,0 +1,155 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/heap.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// Bump allocator for the short-lived containers of one restart. Memory comes
+// from a list of blocks that double in size; reset() rewinds to the first
+// block in O(1) and keeps every block for the next restart, so a worker that
+// runs thousands of restarts stops calling malloc after its largest one.
+// Individual frees are no-ops. Not thread safe: one arena per thread.
+class Arena {
+   public:
+    Arena() {
+        current = 0;
+        used = 0;
+        live = 0;
+        peak = 0;
+    }
+
+    ~Arena() {
+        for (size_t i = 0; i < blocks.size(); i++)
+            free(blocks[i].data);
+    }
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    void *allocate(size_t bytes, size_t align) {
+        while (true) {
+            if (current < blocks.size()) {
+                size_t at = (used + align - 1) & ~(align - 1);
+                if (at + bytes <= blocks[current].size) {
+                    used = at + bytes;
+                    live += bytes;
+                    if (live > peak) peak = live;
+                    return blocks[current].data + at;
+                }
+                // the rest of this block is wasted until the next reset
+                if (current + 1 < blocks.size()) {
+                    current++;
+                    used = 0;
+                    continue;
+                }
+            }
+            size_t size = blocks.empty() ? FIRST_BLOCK : blocks.back().size * 2;
+            while (size < bytes + align)
+                size *= 2;
+            Block block = {(char *)malloc(size), size};
+            if (!block.data) throw std::bad_alloc();
+            blocks.push_back(block);
+            current = blocks.size() - 1;
+            used = 0;
+        }
+    }
+
+    void reset() {
+        current = 0;
+        used = 0;
+        live = 0;
+    }
+
+    // bytes handed out since the last reset, and the most ever
+    size_t bytesUsed() const {
+        return live;
+    }
+    size_t peakBytes() const {
+        return peak;
+    }
+
+    // the calling thread's arena, for restarts running on pool workers
+    static Arena &local() {
+        static thread_local Arena arena;
+        return arena;
+    }
+
+   private:
+    static const size_t FIRST_BLOCK = 64 * 1024;
+
+    struct Block {
+        char *data;
+        size_t size;
+    };
+    std::vector<Block> blocks;
+    size_t current, used;
+    size_t live, peak;
+};
+
+// Standard allocator over an Arena; a null arena falls back to the heap, so
+// containers that take one work the same outside a restart.
+template <typename T>
+class ArenaAllocator {
+   public:
+    typedef T value_type;
+    // containers keep the arena they were built with through copies and swaps
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    Arena *arena;
+
+    ArenaAllocator(Arena *arena = nullptr) {
+        this->arena = arena;
+    }
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) {
+        arena = other.arena;
+    }
+
+    T *allocate(size_t n) {
+        if (!arena) return static_cast<T *>(::operator new(n * sizeof(T)));
+        return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p, size_t) {
+        if (!arena) ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const {
+        return arena == other.arena;
+    }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const {
+        return arena != other.arena;
+    }
+};
+
+// High-water mark of the process heap in bytes: the size of linear memory
+// under Emscripten (it only ever grows), the peak resident set natively.
+inline long long peakHeapBytes() {
+#ifdef __EMSCRIPTEN__
+    return (long long)emscripten_get_heap_size();
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return (long long)usage.ru_maxrss;
+#else
+    return (long long)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+#endif
@@ -0,0 +1,312 @@
+#ifndef ATOMS_H
+#define ATOMS_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// Splits a graph along clique separators, in two stages. Biconnected blocks
+// come first (Hopcroft and Tarjan, O(n + m)): blocks meet in single
+// vertices, the cheapest clique separators there are. Every block that is
+// small enough is then cut into atoms along its clique minimal separators
+// (Berry, Pogorelcnik and Simonet): MCS-M gives a minimal triangulation and
+// the vertices x whose higher neighbourhood madj(x) in it is a minimal
+// separator; walking them in elimination order, each madj(x) that is a
+// clique in the graph splits off the component of x with it.
+//
+// Any tree decomposition of the graph is the atoms' decompositions glued
+// along the links: a link (a, b, separator) joins a bag of atom a and a bag
+// of atom b that both hold the separator (a clique, so each atom's
+// decomposition has such a bag). The links form a tree over the atoms of
+// each connected component; components are linked to atom 0 with an empty
+// separator.
+//
+// G needs a dense vertex count `n` and `forEachNeighbour(v, f)`; nodes lists
+// the vertices to split (closed under adjacency).
+class AtomDecomposition {
+   public:
+    struct Link {
+        int a, b;
+        std::vector<int> separator;
+    };
+
+    std::vector<std::vector<int>> atoms;  // sorted vertex lists
+    std::vector<Link> links;
+
+    // MCS-M takes O(n m) on a block; blocks where n (n + m) is larger than
+    // this stay whole
+    static const long long MCS_M_BUDGET = 1LL << 26;
+
+    template <typename G>
+    AtomDecomposition(const G &g, const std::vector<int> &nodes) : nodes(nodes), adj(nodes.size()) {
+        size = nodes.size();
+        std::vector<int> local(g.n, -1);
+        for (int i = 0; i < size; i++)
+            local[nodes[i]] = i;
+        for (int i = 0; i < size; i++) {
+            g.forEachNeighbour(nodes[i], [&](int u) {
+                if (local[u] >= 0 && local[u] != i) adj[i].push_back(local[u]);
+            });
+            std::sort(adj[i].begin(), adj[i].end());
+            adj[i].erase(std::unique(adj[i].begin(), adj[i].end()), adj[i].end());
+        }
+
+        std::vector<std::vector<int>> blocks;
+        std::vector<int> roots;
+        biconnectedBlocks(blocks, roots);
+
+        // atoms of each block, and which atoms hold each vertex
+        std::vector<int> firstAtom(blocks.size());
+        std::vector<std::vector<int>> atomsOf(size);
+        for (size_t b = 0; b < blocks.size(); b++) {
+            firstAtom[b] = atoms.size();
+            splitBlock(blocks[b]);
+            for (size_t a = firstAtom[b]; a < atoms.size(); a++)
+                for (size_t i = 0; i < atoms[a].size(); i++)
+                    atomsOf[atoms[a][i]].push_back(a);
+        }
+
+        // blocks through a cut vertex hang off the first atom holding it;
+        // the first block of every other component hangs off atom 0
+        for (int v = 0; v < size; v++) {
+            for (size_t i = 1; i < atomsOf[v].size(); i++) {
+                if (blockOf(atomsOf[v][i], firstAtom) == blockOf(atomsOf[v][0], firstAtom)) continue;
+                if (!firstOfBlock(atomsOf[v], i, firstAtom)) continue;
+                links.push_back(Link{atomsOf[v][0], atomsOf[v][i], std::vector<int>(1, v)});
+            }
+        }
+        for (size_t r = 1; r < roots.size(); r++)
+            links.push_back(Link{0, firstAtom[roots[r]], std::vector<int>()});
+
+        for (size_t a = 0; a < atoms.size(); a++) {
+            for (size_t i = 0; i < atoms[a].size(); i++)
+                atoms[a][i] = nodes[atoms[a][i]];
+            std::sort(atoms[a].begin(), atoms[a].end());
+        }
+        for (size_t l = 0; l < links.size(); l++)
+            for (size_t i = 0; i < links[l].separator.size(); i++)
+                links[l].separator[i] = nodes[links[l].separator[i]];
+    }
+
+   private:
+    std::vector<int> nodes;
+    std::vector<std::vector<int>> adj;  // sorted rows over positions in nodes
+    int size;
+
+    bool adjacent(int a, int b) const {
+        return std::binary_search(adj[a].begin(), adj[a].end(), b);
+    }
+
+    static int blockOf(int atom, const std::vector<int> &firstAtom) {
+        return std::upper_bound(firstAtom.begin(), firstAtom.end(), atom) - firstAtom.begin() - 1;
+    }
+
+    // whether list[i] is the first atom of its block in list
+    static bool firstOfBlock(const std::vector<int> &list, size_t i, const std::vector<int> &firstAtom) {
+        int block = blockOf(list[i], firstAtom);
+        for (size_t j = 0; j < i; j++)
+            if (blockOf(list[j], firstAtom) == block) return false;
+        return true;
+    }
+
+    // Iterative Hopcroft-Tarjan: a vertex stack, and a block popped off it
+    // each time a child cannot reach above its parent. roots gets the index
+    // of the first block of every component (isolated vertices are blocks
+    // of their own).
+    void biconnectedBlocks(std::vector<std::vector<int>> &blocks, std::vector<int> &roots) {
+        std::vector<int> disc(size, -1), low(size, 0), parent(size, -1), cursor(size, 0);
+        std::vector<int> stack, path;
+        int time = 0;
+        for (int root = 0; root < size; root++) {
+            if (disc[root] >= 0) continue;
+            roots.push_back(blocks.size());
+            disc[root] = low[root] = time++;
+            stack.push_back(root);
+            path.push_back(root);
+            while (!path.empty()) {
+                int v = path.back();
+                if (cursor[v] < (int)adj[v].size()) {
+                    int u = adj[v][cursor[v]++];
+                    if (disc[u] < 0) {
+                        parent[u] = v;
+                        disc[u] = low[u] = time++;
+                        stack.push_back(u);
+                        path.push_back(u);
+                    } else if (u != parent[v]) {
+                        low[v] = std::min(low[v], disc[u]);
+                    }
+                    continue;
+                }
+                path.pop_back();
+                int p = parent[v];
+                if (p < 0) {
+                    if (adj[v].empty()) blocks.push_back(std::vector<int>(1, v));
+                    stack.pop_back();
+                    continue;
+                }
+                low[p] = std::min(low[p], low[v]);
+                if (low[v] >= disc[p]) {
+                    std::vector<int> block(1, p);
+                    while (true) {
+                        int w = stack.back();
+                        stack.pop_back();
+                        block.push_back(w);
+                        if (w == v) break;
+                    }
+                    blocks.push_back(block);
+                }
+            }
+        }
+    }
+
+    // Appends the atoms of one block (positions in nodes) and the links
+    // between them.
+    void splitBlock(const std::vector<int> &block) {
+        int nb = block.size();
+        long long edges = 0;
+        for (int i = 0; i < nb; i++)
+            edges += adj[block[i]].size();
+        if (nb < 3 || (long long)nb * (nb + edges) > MCS_M_BUDGET) {
+            atoms.push_back(block);
+            return;
+        }
+
+        // MCS-M+ over the block: order[i] is the vertex numbered i (numbers
+        // go down, so order[0] is eliminated first), madj[v] the vertices
+        // numbered before v that it got a triangulation edge from, and
+        // generator[v] marks v whose madj is a minimal separator
+        std::vector<int> in(size, -1);
+        for (int i = 0; i < nb; i++)
+            in[block[i]] = i;
+        std::vector<int> weight(nb, 0), number(nb, -1), order(nb), stamp(nb, -1);
+        std::vector<std::vector<int>> madj(nb), reach(nb);
+        std::vector<char> generator(nb, 0);
+        std::vector<int> raised;
+        int previous = -1;
+        for (int i = nb - 1; i >= 0; i--) {
+            int v = -1;
+            for (int u = 0; u < nb; u++)
+                if (number[u] < 0 && (v < 0 || weight[u] > weight[v])) v = u;
+            if (weight[v] <= previous) generator[v] = 1;
+            previous = weight[v];
+            number[v] = i;
+            order[i] = v;
+            stamp[v] = i;
+
+            // u gets an edge to v when a path v..u runs through unnumbered
+            // vertices of weight below weight[u]; reach[j] holds the
+            // vertices reachable with largest inner weight j
+            raised.clear();
+            for (size_t e = 0; e < adj[block[v]].size(); e++) {
+                int u = in[adj[block[v]][e]];
+                if (u < 0 || number[u] >= 0) continue;
+                stamp[u] = i;
+                reach[weight[u]].push_back(u);
+                raised.push_back(u);
+            }
+            for (int j = 0; j < nb; j++) {
+                while (!reach[j].empty()) {
+                    int u = reach[j].back();
+                    reach[j].pop_back();
+                    for (size_t e = 0; e < adj[block[u]].size(); e++) {
+                        int z = in[adj[block[u]][e]];
+                        if (z < 0 || number[z] >= 0 || stamp[z] == i) continue;
+                        stamp[z] = i;
+                        if (weight[z] > j) {
+                            reach[weight[z]].push_back(z);
+                            raised.push_back(z);
+                        } else {
+                            reach[j].push_back(z);
+                        }
+                    }
+                }
+            }
+            for (size_t r = 0; r < raised.size(); r++) {
+                weight[raised[r]]++;
+                madj[raised[r]].push_back(v);
+            }
+        }
+
+        // Atoms: cut along each clique madj(x) in elimination order; alive
+        // marks what is left of the block
+        int firstAtom = atoms.size();
+        std::vector<char> alive(nb, 1), inSeparator(nb, 0);
+        std::vector<int> seen(nb, -1), queue;
+        std::vector<std::vector<int>> separators;
+        int left = nb;
+        for (int i = 0; i < nb; i++) {
+            int x = order[i];
+            if (!generator[x] || !alive[x]) continue;
+            std::vector<int> separator;
+            for (size_t s = 0; s < madj[x].size(); s++)
+                if (alive[madj[x][s]]) separator.push_back(madj[x][s]);
+            if (!isClique(separator, block)) continue;
+
+            for (size_t s = 0; s < separator.size(); s++)
+                inSeparator[separator[s]] = 1;
+            queue.assign(1, x);
+            seen[x] = i;
+            for (size_t q = 0; q < queue.size(); q++) {
+                int u = queue[q];
+                for (size_t e = 0; e < adj[block[u]].size(); e++) {
+                    int z = in[adj[block[u]][e]];
+                    if (z < 0 || !alive[z] || inSeparator[z] || seen[z] == i) continue;
+                    seen[z] = i;
+                    queue.push_back(z);
+                }
+            }
+            for (size_t s = 0; s < separator.size(); s++)
+                inSeparator[separator[s]] = 0;
+            // nothing on the other side: not a separator of what is left
+            if ((int)(queue.size() + separator.size()) == left) continue;
+
+            std::vector<int> atom;
+            for (size_t q = 0; q < queue.size(); q++) {
+                alive[queue[q]] = 0;
+                atom.push_back(block[queue[q]]);
+            }
+            for (size_t s = 0; s < separator.size(); s++)
+                atom.push_back(block[separator[s]]);
+            left -= queue.size();
+            atoms.push_back(atom);
+            separators.push_back(separator);
+        }
+        std::vector<int> rest;
+        for (int v = 0; v < nb; v++)
+            if (alive[v]) rest.push_back(block[v]);
+        atoms.push_back(rest);
+
+        // each split-off atom hangs off the first later atom that holds its
+        // separator; the separator is a clique, so one does
+        std::vector<std::vector<int>> atomsOf(nb);
+        for (size_t a = firstAtom; a < atoms.size(); a++)
+            for (size_t i = 0; i < atoms[a].size(); i++)
+                atomsOf[in[atoms[a][i]]].push_back(a);
+        for (size_t s = 0; s < separators.size(); s++) {
+            int a = firstAtom + s;
+            const std::vector<int> &separator = separators[s];
+            const std::vector<int> &candidates = atomsOf[separator[0]];
+            for (size_t c = 0; c < candidates.size(); c++) {
+                int b = candidates[c];
+                bool holds = b > a;
+                for (size_t i = 1; i < separator.size() && holds; i++)
+                    holds = std::binary_search(atomsOf[separator[i]].begin(), atomsOf[separator[i]].end(), b);
+                if (!holds) continue;
+                std::vector<int> ids;
+                for (size_t i = 0; i < separator.size(); i++)
+                    ids.push_back(block[separator[i]]);
+                links.push_back(Link{a, b, ids});
+                break;
+            }
+        }
+    }
+
+    bool isClique(const std::vector<int> &set, const std::vector<int> &block) const {
+        for (size_t i = 0; i < set.size(); i++)
+            for (size_t j = i + 1; j < set.size(); j++)
+                if (!adjacent(block[set[i]], block[set[j]])) return false;
+        return true;
+    }
+};
+
+#endif
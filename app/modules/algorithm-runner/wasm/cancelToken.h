@@ -0,0 +1,81 @@
+#ifndef CANCEL_TOKEN_H
+#define CANCEL_TOKEN_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+// Stop signal of one run, shared by all of its threads. A run stops once its
+// deadline passes, once cancel() is called (natively, e.g. from a signal
+// handler), or once the outside poll returns true. The poll reads state that
+// only the owning thread may touch (a JS SharedArrayBuffer flag), so it is
+// only ever called there; the other threads see the result through the
+// shared flag.
+class CancelToken {
+   public:
+    CancelToken() : flag(false) {
+        owner = std::this_thread::get_id();
+        hasDeadline = false;
+    }
+
+    void setTimeLimit(double ms) {
+        deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(ms));
+        hasDeadline = true;
+    }
+
+    void setPoll(std::function<bool()> poll) {
+        this->poll = poll;
+    }
+
+    void cancel() {
+        flag.store(true, std::memory_order_relaxed);
+    }
+
+    // one relaxed load, safe to call anywhere
+    bool cancelled() const {
+        return flag.load(std::memory_order_relaxed);
+    }
+
+    // also reads the clock and, on the owning thread, the outside flag
+    bool check() {
+        if (cancelled()) return true;
+        if (hasDeadline && Clock::now() >= deadline)
+            cancel();
+        else if (poll && std::this_thread::get_id() == owner && poll())
+            cancel();
+        return cancelled();
+    }
+
+   private:
+    typedef std::chrono::steady_clock Clock;
+
+    std::atomic<bool> flag;
+    std::thread::id owner;
+    bool hasDeadline;
+    Clock::time_point deadline;
+    std::function<bool()> poll;
+};
+
+// What hot loops call: a per-thread counter in front of a CancelToken that
+// only does the full check every 256th call. Without a token it is always
+// false.
+class CancelCheck {
+   public:
+    CancelCheck(CancelToken *token = nullptr) {
+        this->token = token;
+        ticks = 0;
+    }
+
+    bool operator()() {
+        if (!token) return false;
+        if (++ticks & 255) return token->cancelled();
+        return token->check();
+    }
+
+   private:
+    CancelToken *token;
+    unsigned int ticks;
+};
+
+#endif
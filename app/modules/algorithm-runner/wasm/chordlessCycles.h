@@ -0,0 +1,254 @@
+#ifndef CHORDLESS_CYCLES_H
+#define CHORDLESS_CYCLES_H
+
+#include <vector>
+
+#include "arena.h"
+#include "cancelToken.h"
+
+// Lazy enumeration of the chordless cycles of a graph, by the labelled
+// triple scheme of Graph::ChordlessCycles: every cycle is found once, from
+// the path x-u-y through its lowest labelled vertex u, by growing chordless
+// paths that only use vertices labelled above u.
+//
+// The search runs over a snapshot of the adjacency taken by the constructor
+// and keeps one path and one neighbour cursor per path vertex, so memory is
+// O(n + m) however many cycles there are. Chords the caller adds while
+// enumerating go through addChord: no cycle holding both ends of one is
+// yielded, and every partial path that holds both is abandoned at once.
+//
+// G needs a dense vertex count `n`, `degree(v)` and `forEachNeighbour(v, f)`;
+// nodes lists the vertices to search (closed under adjacency) and labels
+// gives each a distinct label.
+class ChordlessCycleStream {
+   public:
+    typedef std::vector<int, ArenaAllocator<int>> IntVector;
+
+    // maxCycles > 0 stops after that many cycles; interrupted (may be null)
+    // is polled as the search goes and ends it when it fires
+    template <typename G>
+    ChordlessCycleStream(const G &g, const std::vector<int> &nodes, const std::vector<int> &labels,
+                         long long maxCycles = 0, CancelCheck *interrupted = nullptr, Arena *arena = nullptr)
+        : labels(labels),
+          nodes(nodes),
+          offsets(g.n + 1, 0, arena),
+          targets(arena),
+          blocked(g.n, 0, arena),
+          adjacentToX(g.n, -1, arena),
+          pathIndex(g.n, -1, arena),
+          path(arena),
+          cursor(arena),
+          chordHead(g.n, -1, arena),
+          chordNext(arena),
+          chordTo(arena) {
+        this->maxCycles = maxCycles;
+        this->interrupted = interrupted;
+        for (size_t i = 0; i < nodes.size(); i++)
+            offsets[nodes[i] + 1] = g.degree(nodes[i]);
+        for (int v = 0; v < (int)g.n; v++)
+            offsets[v + 1] += offsets[v];
+        targets.resize(offsets[g.n]);
+        for (size_t i = 0; i < nodes.size(); i++) {
+            int at = offsets[nodes[i]];
+            g.forEachNeighbour(nodes[i], [&](int w) { targets[at++] = w; });
+        }
+        nodeAt = 0;
+        xAt = yAt = -1;
+        cut = NONE;
+        closed = false;
+        paths = cycles = 0;
+    }
+
+    // Moves to the next chordless cycle; false once there are none left, the
+    // cap is reached or interrupted fired.
+    bool next() {
+        if (closed) {
+            popVertex();
+            closed = false;
+        }
+        if (maxCycles > 0 && cycles >= maxCycles) return false;
+        while (true) {
+            if (interrupted && (*interrupted)()) return false;
+            // a chord between two path vertices kills every extension
+            while (cut != NONE && (int)path.size() > cut) {
+                if (path.size() <= 3) {
+                    endTriple();
+                    break;
+                }
+                popVertex();
+            }
+            cut = NONE;
+
+            if (path.empty() && !nextTriple()) return false;
+
+            int last = path.back();
+            int &at = cursor.back();
+            if (at == offsets[last + 1]) {
+                if (path.size() == 3)
+                    endTriple();
+                else
+                    popVertex();
+                continue;
+            }
+            int c = targets[at++];
+            if (labels[c] <= labels[path[1]] || blocked[c] != 1 || chordToPath(c)) continue;
+            pushVertex(c);
+            if (adjacentToX[c] == xStamp) {
+                closed = true;
+                cycles++;
+                return true;
+            }
+        }
+    }
+
+    // x-u-y-...: the cycle next() stopped at, valid until the next call
+    const IntVector &cycle() const {
+        return path;
+    }
+
+    // Records the chord u-v the caller just added to its graph.
+    void addChord(int u, int v) {
+        addArc(u, v);
+        addArc(v, u);
+        if (pathIndex[u] >= 0 && pathIndex[v] >= 0) {
+            int deepest = pathIndex[u] > pathIndex[v] ? pathIndex[u] : pathIndex[v];
+            if (deepest < cut) cut = deepest;
+        }
+    }
+
+    // chordless paths x-u-y started from, and cycles yielded
+    long long pathCount() const {
+        return paths;
+    }
+    long long cycleCount() const {
+        return cycles;
+    }
+
+   private:
+    static const int NONE = 1 << 30;
+
+    const std::vector<int> &labels;
+    const std::vector<int> &nodes;
+    // the snapshot: row v is targets[offsets[v] .. offsets[v + 1])
+    IntVector offsets, targets;
+    // path vertices (from u on) adjacent to each vertex
+    IntVector blocked;
+    // equals xStamp for the neighbours of the current x
+    IntVector adjacentToX;
+    int xStamp;
+    // position on the path, -1 when off it
+    IntVector pathIndex;
+    IntVector path;
+    // next snapshot neighbour to try, one per path vertex from y on
+    IntVector cursor;
+    // chords added through addChord, as linked arcs per vertex
+    IntVector chordHead, chordNext, chordTo;
+
+    long long maxCycles;
+    CancelCheck *interrupted;
+    // triple cursor: nodes[nodeAt] is u, x and y are offsets into its row
+    size_t nodeAt;
+    int xAt, yAt;
+    // path length to cut back to before going on, NONE if nothing to cut
+    int cut;
+    // path ends in the vertex that closed the last cycle
+    bool closed;
+    long long paths, cycles;
+
+    void block(int v, int delta) {
+        for (int at = offsets[v]; at < offsets[v + 1]; at++) {
+            int w = targets[at];
+            if (delta > 0)
+                blocked[w]++;
+            else if (blocked[w] > 0)
+                blocked[w]--;
+        }
+    }
+
+    void pushVertex(int v) {
+        pathIndex[v] = path.size();
+        path.push_back(v);
+        block(v, 1);
+        cursor.push_back(offsets[v]);
+    }
+
+    void popVertex() {
+        int v = path.back();
+        block(v, -1);
+        pathIndex[v] = -1;
+        path.pop_back();
+        cursor.pop_back();
+    }
+
+    // drops y, u and x, leaving the path empty
+    void endTriple() {
+        while (path.size() > 3)
+            popVertex();
+        popVertex();
+        block(path[1], -1);
+        pathIndex[path[0]] = pathIndex[path[1]] = -1;
+        path.clear();
+    }
+
+    bool chordToPath(int v) const {
+        for (int a = chordHead[v]; a != -1; a = chordNext[a])
+            if (pathIndex[chordTo[a]] >= 0) return true;
+        return false;
+    }
+
+    bool chord(int u, int v) const {
+        for (int a = chordHead[u]; a != -1; a = chordNext[a])
+            if (chordTo[a] == v) return true;
+        return false;
+    }
+
+    void addArc(int u, int v) {
+        chordNext.push_back(chordHead[u]);
+        chordTo.push_back(v);
+        chordHead[u] = chordTo.size() - 1;
+    }
+
+    // Sets the path to the next x-u-y with labels u < x < y and x, y not
+    // adjacent, blocks the neighbours of u and y and puts y's cursor first.
+    bool nextTriple() {
+        while (nodeAt < nodes.size()) {
+            int u = nodes[nodeAt];
+            int begin = offsets[u], end = offsets[u + 1];
+            if (xAt < 0) xAt = begin;
+            while (xAt < end) {
+                int x = targets[xAt];
+                if (labels[x] <= labels[u]) {
+                    xAt++;
+                    yAt = -1;
+                    continue;
+                }
+                if (yAt < 0) {
+                    // x changes: mark its neighbours once for all its y
+                    yAt = begin;
+                    xStamp = xAt;
+                    for (int at = offsets[x]; at < offsets[x + 1]; at++)
+                        adjacentToX[targets[at]] = xStamp;
+                }
+                while (yAt < end) {
+                    int y = targets[yAt++];
+                    if (labels[y] <= labels[x] || adjacentToX[y] == xStamp || chord(x, y)) continue;
+                    paths++;
+                    pathIndex[x] = 0;
+                    path.push_back(x);
+                    pathIndex[u] = 1;
+                    path.push_back(u);
+                    block(u, 1);
+                    pushVertex(y);
+                    return true;
+                }
+                xAt++;
+                yAt = -1;
+            }
+            nodeAt++;
+            xAt = -1;
+        }
+        return false;
+    }
+};
+
+#endif
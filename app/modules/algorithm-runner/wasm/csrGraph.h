@@ -0,0 +1,175 @@
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// Immutable adjacency in compressed sparse row form. Vertices are dense ids
+// 0..n-1, idOf maps them back to the (sorted) ids the caller used, so the
+// dense order is the same as the order of the original vertex ids.
+class CsrGraph {
+   public:
+    int n;
+    std::vector<int> offsets;  // row v is targets[offsets[v] .. offsets[v + 1])
+    std::vector<int> targets;  // sorted inside each row, no duplicates
+    std::vector<int> idOf;     // dense id -> external id
+
+    CsrGraph() {
+        n = 0;
+        offsets.push_back(0);
+    }
+
+    // ids must be sorted and unique; edges are given in dense ids.
+    // Self loops and duplicate edges are dropped.
+    CsrGraph(std::vector<int> ids, const std::vector<std::pair<int, int>> &edges) {
+        n = ids.size();
+        idOf.swap(ids);
+
+        std::vector<int> count(n + 1, 0);
+        for (size_t i = 0; i < edges.size(); i++) {
+            if (edges[i].first == edges[i].second) continue;
+            count[edges[i].first + 1]++;
+            count[edges[i].second + 1]++;
+        }
+        for (int v = 0; v < n; v++)
+            count[v + 1] += count[v];
+
+        std::vector<int> pos(count.begin(), count.end() - 1);
+        std::vector<int> raw(count[n]);
+        for (size_t i = 0; i < edges.size(); i++) {
+            int u = edges[i].first, v = edges[i].second;
+            if (u == v) continue;
+            raw[pos[u]++] = v;
+            raw[pos[v]++] = u;
+        }
+
+        // sort every row and squeeze out duplicates in place
+        offsets.assign(n + 1, 0);
+        int out = 0;
+        for (int v = 0; v < n; v++) {
+            int *rowBegin = raw.data() + count[v];
+            int *rowEnd = raw.data() + count[v + 1];
+            std::sort(rowBegin, rowEnd);
+            int *last = std::unique(rowBegin, rowEnd);
+            offsets[v] = out;
+            for (int *it = rowBegin; it != last; it++)
+                raw[out++] = *it;
+        }
+        offsets[n] = out;
+        raw.resize(out);
+        targets.swap(raw);
+    }
+
+    // Graph over external ids straight from flat input arrays: nodes in any
+    // order (repeats allowed), edges as u0 v0 u1 v1 ... Edges with an endpoint
+    // that is not in nodes are dropped. Endpoints are mapped through a direct
+    // table when the ids are dense enough, by binary search otherwise.
+    static CsrGraph fromIds(const int *nodes, size_t nodeCount, const int *edges, size_t edgeCount) {
+        std::vector<int> ids(nodes, nodes + nodeCount);
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+        std::vector<int> table;
+        long long low = ids.empty() ? 0 : ids.front();
+        long long range = ids.empty() ? 0 : (long long)ids.back() - low + 1;
+        if (range <= 4 * (long long)ids.size() + 64) {
+            table.assign(range, -1);
+            for (size_t i = 0; i < ids.size(); i++)
+                table[ids[i] - low] = i;
+        }
+
+        std::vector<std::pair<int, int>> dense;
+        dense.reserve(edgeCount);
+        for (size_t i = 0; i < edgeCount; i++) {
+            int u, v;
+            if (!table.empty()) {
+                long long a = edges[2 * i] - low, b = edges[2 * i + 1] - low;
+                u = a >= 0 && a < range ? table[a] : -1;
+                v = b >= 0 && b < range ? table[b] : -1;
+            } else {
+                u = indexIn(ids, edges[2 * i]);
+                v = indexIn(ids, edges[2 * i + 1]);
+            }
+            if (u >= 0 && v >= 0) dense.push_back(std::make_pair(u, v));
+        }
+        return CsrGraph(std::move(ids), dense);
+    }
+
+    int degree(int v) const {
+        return offsets[v + 1] - offsets[v];
+    }
+
+    const int *begin(int v) const {
+        return targets.data() + offsets[v];
+    }
+
+    const int *end(int v) const {
+        return targets.data() + offsets[v + 1];
+    }
+
+    bool hasEdge(int u, int v) const {
+        return std::binary_search(begin(u), end(u), v);
+    }
+
+    int edgeCount() const {
+        return targets.size() / 2;
+    }
+
+    // dense id of an external vertex id, -1 if it is not a vertex
+    int denseIdOf(int id) const {
+        return indexIn(idOf, id);
+    }
+
+    // position of id in a sorted id table, -1 if absent
+    static int indexIn(const std::vector<int> &ids, int id) {
+        std::vector<int>::const_iterator it = std::lower_bound(ids.begin(), ids.end(), id);
+        if (it == ids.end() || *it != id) return -1;
+        return it - ids.begin();
+    }
+};
+
+// Edges added on top of a CsrGraph while triangulating. Stored as one singly
+// linked arc list per vertex inside flat arrays, so a restart starts from an
+// empty set of chords without touching the CSR rows.
+class FillEdges {
+   public:
+    std::vector<int> head;    // first arc of each vertex, -1 if none
+    std::vector<int> next;    // next arc of the same tail, -1 at the end
+    std::vector<int> to;      // arc head
+    std::vector<int> degree;  // number of fill arcs leaving each vertex
+
+    void reset(int n) {
+        head.assign(n, -1);
+        degree.assign(n, 0);
+        next.clear();
+        to.clear();
+    }
+
+    void add(int u, int v) {
+        addArc(u, v);
+        addArc(v, u);
+    }
+
+    bool contains(int u, int v) const {
+        // walk the shorter of the two lists
+        if (degree[v] < degree[u]) std::swap(u, v);
+        for (int a = head[u]; a != -1; a = next[a])
+            if (to[a] == v) return true;
+        return false;
+    }
+
+    int size() const {
+        return to.size() / 2;
+    }
+
+   private:
+    void addArc(int u, int v) {
+        to.push_back(v);
+        next.push_back(head[u]);
+        head[u] = to.size() - 1;
+        degree[u]++;
+    }
+};
+
+#endif
@@ -0,0 +1,261 @@
+#ifndef DECOMPOSITION_CACHE_H
+#define DECOMPOSITION_CACHE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "csrGraph.h"
+
+// Content address of the subgraph of g on nodes (sorted dense ids, closed
+// under adjacency), as the caller sees it: names maps dense ids to the
+// caller's ids and must be increasing. The words hashed are the vertex
+// count, then each vertex's name followed by the names of its higher
+// neighbours. This is the normalised edge list, in the order CSR rows
+// already have, so no sort is needed. FNV-1a over the words, finished with
+// the splitmix64 mixer. salt goes in first and keeps apart entries of the
+// same graph that must not stand in for each other (see settingsSalt).
+inline uint64_t graphKey(const CsrGraph &g, const std::vector<int> &nodes, const std::vector<int> &names,
+                         uint64_t salt = 0) {
+    uint64_t h = 14695981039346656037ULL;
+    auto word = [&h](uint32_t x) { h = (h ^ x) * 1099511628211ULL; };
+    word(salt);
+    word(salt >> 32);
+    word(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++) {
+        int v = nodes[i];
+        word(names[v]);
+        for (const int *it = g.begin(v); it != g.end(v); it++)
+            if (*it > v) word(names[*it]);
+        // ends the row, so (1: 2, 3) and (1: 2)(3) differ
+        word(0x9e3779b9u);
+    }
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+// Where cache entries outlive the process: load and store serialised
+// entries under a 16-digit hex key.
+class CacheBackend {
+   public:
+    virtual ~CacheBackend() {}
+    virtual bool load(const std::string &key, std::string &data) = 0;
+    virtual void store(const std::string &key, const std::string &data) = 0;
+};
+
+// One file per entry, <directory>/<key>.tdc; written to a temporary file
+// first and renamed, so a reader never sees half an entry.
+class FileCacheBackend : public CacheBackend {
+   public:
+    explicit FileCacheBackend(const std::string &directory) : directory(directory) {}
+
+    bool load(const std::string &key, std::string &data) {
+        FILE *in = fopen(path(key).c_str(), "rb");
+        if (!in) return false;
+        data.clear();
+        char buffer[1 << 14];
+        size_t got;
+        while ((got = fread(buffer, 1, sizeof(buffer), in)) > 0)
+            data.append(buffer, got);
+        fclose(in);
+        return true;
+    }
+
+    void store(const std::string &key, const std::string &data) {
+        std::string target = path(key), temporary = target + ".tmp";
+        FILE *out = fopen(temporary.c_str(), "wb");
+        if (!out) return;
+        bool written = fwrite(data.data(), 1, data.size(), out) == data.size();
+        written = fclose(out) == 0 && written;
+        if (written)
+            rename(temporary.c_str(), target.c_str());
+        else
+            remove(temporary.c_str());
+    }
+
+   private:
+    std::string directory;
+
+    std::string path(const std::string &key) const {
+        return directory + "/" + key + ".tdc";
+    }
+};
+
+// Best decompositions seen so far, by graphKey, in a least recently used
+// list of at most capacity entries in memory and optionally a backend
+// behind it. Entries hold the caller's ids, so they carry over between runs
+// and graphs that share a component. Not thread-safe: one run at a time.
+class DecompositionCache {
+   public:
+    struct Entry {
+        int width;
+        int lowerBound;
+        // a full run ended with this tree; otherwise it is only a good start
+        bool complete;
+        std::vector<std::vector<int>> bags;
+        std::vector<std::pair<int, int>> edges;  // between bag indices
+
+        Entry() {
+            width = -1;
+            lowerBound = 0;
+            complete = false;
+        }
+    };
+
+    // smaller graphs take less to solve than to look up
+    static const int MIN_VERTICES = 10;
+
+    explicit DecompositionCache(size_t capacity = 256) {
+        this->capacity = capacity;
+        backend = nullptr;
+    }
+
+    // null = memory only; the cache does not own it
+    void setBackend(CacheBackend *backend) {
+        this->backend = backend;
+    }
+
+    size_t size() const {
+        return order.size();
+    }
+
+    // the entry of key, from memory or else the backend; entry is left
+    // alone on a miss
+    bool lookup(uint64_t key, Entry &entry) {
+        std::unordered_map<uint64_t, std::list<Item>::iterator>::iterator it = index.find(key);
+        if (it != index.end()) {
+            order.splice(order.begin(), order, it->second);
+            entry = it->second->second;
+            return true;
+        }
+        std::string data;
+        Entry loaded;
+        if (!backend || !backend->load(hex(key), data) || !parse(data, loaded)) return false;
+        remember(key, loaded);
+        entry = loaded;
+        return true;
+    }
+
+    // Keeps the narrower of entry and what key has already, the larger lower
+    // bound of the two and complete if either is; writes through to the
+    // backend when that changed anything.
+    void store(uint64_t key, const Entry &entry) {
+        Entry merged;
+        if (!lookup(key, merged)) {
+            merged = entry;
+        } else if (entry.width < merged.width) {
+            int lowerBound = std::max(merged.lowerBound, entry.lowerBound);
+            bool complete = merged.complete || entry.complete;
+            merged = entry;
+            merged.lowerBound = lowerBound;
+            merged.complete = complete;
+        } else {
+            int lowerBound = std::max(merged.lowerBound, entry.lowerBound);
+            bool complete = merged.complete || entry.complete;
+            if (lowerBound == merged.lowerBound && complete == merged.complete) return;
+            merged.lowerBound = lowerBound;
+            merged.complete = complete;
+        }
+        remember(key, merged);
+        if (backend) backend->store(hex(key), serialize(merged));
+    }
+
+    // "w <width> <lowerBound> <complete> <bags> <edges>", one line per bag
+    // of its size and members, then the edge pairs
+    static std::string serialize(const Entry &entry) {
+        std::string out = "w " + std::to_string(entry.width) + " " + std::to_string(entry.lowerBound) + " " +
+                          (entry.complete ? "1 " : "0 ") + std::to_string(entry.bags.size()) + " " +
+                          std::to_string(entry.edges.size()) + "\n";
+        for (size_t b = 0; b < entry.bags.size(); b++) {
+            out += std::to_string(entry.bags[b].size());
+            for (size_t i = 0; i < entry.bags[b].size(); i++)
+                out += " " + std::to_string(entry.bags[b][i]);
+            out += "\n";
+        }
+        for (size_t e = 0; e < entry.edges.size(); e++)
+            out += std::to_string(entry.edges[e].first) + " " + std::to_string(entry.edges[e].second) + "\n";
+        return out;
+    }
+
+    // false, leaving entry in any state, on anything malformed
+    static bool parse(const std::string &data, Entry &entry) {
+        const char *at = data.c_str();
+        if (*at++ != 'w') return false;
+        long long width, lowerBound, complete, bags, edges;
+        if (!next(at, width) || !next(at, lowerBound) || !next(at, complete) || !next(at, bags) || !next(at, edges))
+            return false;
+        if (bags < 0 || edges < 0 || (long long)data.size() < bags + edges) return false;
+        entry.width = width;
+        entry.lowerBound = lowerBound;
+        entry.complete = complete != 0;
+        entry.bags.assign(bags, std::vector<int>());
+        for (long long b = 0; b < bags; b++) {
+            long long size, x;
+            if (!next(at, size) || size < 0 || size > (long long)data.size()) return false;
+            for (long long i = 0; i < size; i++) {
+                if (!next(at, x)) return false;
+                entry.bags[b].push_back(x);
+            }
+        }
+        entry.edges.clear();
+        for (long long e = 0; e < edges; e++) {
+            long long a, b;
+            if (!next(at, a) || !next(at, b) || a < 0 || b < 0 || a >= bags || b >= bags) return false;
+            entry.edges.push_back(std::make_pair((int)a, (int)b));
+        }
+        return true;
+    }
+
+    static std::string hex(uint64_t key) {
+        char buffer[17];
+        snprintf(buffer, sizeof(buffer), "%016llx", (unsigned long long)key);
+        return buffer;
+    }
+
+   private:
+    typedef std::pair<uint64_t, Entry> Item;
+
+    size_t capacity;
+    CacheBackend *backend;
+    std::list<Item> order;  // most recently used first
+    std::unordered_map<uint64_t, std::list<Item>::iterator> index;
+
+    void remember(uint64_t key, const Entry &entry) {
+        std::unordered_map<uint64_t, std::list<Item>::iterator>::iterator it = index.find(key);
+        if (it != index.end()) {
+            it->second->second = entry;
+            order.splice(order.begin(), order, it->second);
+            return;
+        }
+        order.push_front(Item(key, entry));
+        index[key] = order.begin();
+        while (order.size() > capacity) {
+            index.erase(order.back().first);
+            order.pop_back();
+        }
+    }
+
+    // the next integer after blanks, false at the end or on anything else
+    static bool next(const char *&at, long long &x) {
+        while (*at == ' ' || *at == '\n' || *at == '\r' || *at == '\t')
+            at++;
+        char *end;
+        x = strtoll(at, &end, 10);
+        if (end == at) return false;
+        at = end;
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,383 @@
+#ifndef DECOMPOSITION_SESSION_H
+#define DECOMPOSITION_SESSION_H
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "treeWidthCore.h"
+
+// A graph edited one vertex or edge at a time, as in the editor, together
+// with a tree decomposition of each connected component. Every edit leaves
+// each component's tree valid:
+//
+//   addVertex     a component of its own with the bag {v}
+//   addEdge       nothing to do when a bag holds both ends; otherwise u is
+//                 put into every bag on the tree path to a bag holding v
+//                 (the two trees are joined first if u and v were apart),
+//                 which widens the tree by one at most
+//   removeEdge,   the tree stays valid; a component that falls apart keeps
+//   removeVertex  the share of the bags of each piece
+//
+// Edits that may leave room for a narrower tree mark their component dirty,
+// and decompose() runs only the dirty components again. A new tree replaces
+// the old one only if it is narrower. Lower bounds survive added edges
+// (treewidth never drops when the graph grows). Removals reset them.
+//
+// Vertices are the caller's ids throughout.
+class DecompositionSession {
+   public:
+    DecompositionSession() {
+        nextComponent = 0;
+    }
+
+    // false if v is there already
+    bool addVertex(int v) {
+        if (adj.count(v)) return false;
+        adj[v];
+        Component &c = components[nextComponent];
+        c.vertices.insert(v);
+        c.bags.push_back(std::set<int>(&v, &v + 1));
+        c.lowerBound = 0;
+        c.dirty = false;
+        componentOf[v] = nextComponent++;
+        return true;
+    }
+
+    // Adds missing endpoints too. False when the edge was there already or a
+    // bag holds both ends: then no component got dirty. Self loops are
+    // ignored, as in CsrGraph.
+    bool addEdge(int u, int v) {
+        if (u == v) return false;
+        addVertex(u);
+        addVertex(v);
+        if (adj[u].count(v)) return false;
+        adj[u].insert(v);
+        adj[v].insert(u);
+
+        int key = componentOf[u];
+        if (componentOf[v] != key) {
+            key = merge(key, componentOf[v], u, v);
+        } else {
+            const Component &c = components[key];
+            for (size_t b = 0; b < c.bags.size(); b++)
+                if (c.bags[b].count(u) && c.bags[b].count(v)) return false;
+        }
+
+        Component &c = components[key];
+        std::vector<int> path = treePath(c, bagWith(c, u), bagWith(c, v));
+        for (size_t i = 0; i < path.size(); i++)
+            c.bags[path[i]].insert(u);
+        c.dirty = true;
+        return true;
+    }
+
+    // false if there is no such edge
+    bool removeEdge(int u, int v) {
+        if (!adj.count(u) || !adj[u].count(v)) return false;
+        adj[u].erase(v);
+        adj[v].erase(u);
+        int key = componentOf[u];
+        components[key].dirty = true;
+        components[key].lowerBound = 0;
+        split(key, false);
+        return true;
+    }
+
+    // false if there is no such vertex
+    bool removeVertex(int v) {
+        if (!adj.count(v)) return false;
+        for (int u : adj[v])
+            adj[u].erase(v);
+        adj.erase(v);
+        int key = componentOf[v];
+        componentOf.erase(v);
+        components[key].vertices.erase(v);
+        if (components[key].vertices.empty())
+            components.erase(key);
+        else
+            split(key, true);
+        return true;
+    }
+
+    // vertex ids in increasing order; the dense ids of decompose()
+    std::vector<int> ids() const {
+        std::vector<int> ret;
+        ret.reserve(adj.size());
+        for (std::map<int, std::set<int>>::const_iterator it = adj.begin(); it != adj.end(); it++)
+            ret.push_back(it->first);
+        return ret;
+    }
+
+    int componentCount() const {
+        return components.size();
+    }
+
+    int dirtyCount() const {
+        int count = 0;
+        for (std::map<int, Component>::const_iterator it = components.begin(); it != components.end(); it++)
+            count += it->second.dirty;
+        return count;
+    }
+
+    // Decomposes the dirty components again with options and returns the
+    // tree of the whole graph, over the dense ids of ids(); the caller owns
+    // it. options.onProgress sees the whole graph each time a component
+    // improves. A component whose run options.cancel cut short stays dirty.
+    Tree *decompose(const RunOptions &options) {
+        std::vector<int> idOf = ids();
+        for (std::map<int, Component>::iterator it = components.begin(); it != components.end(); it++) {
+            Component &c = it->second;
+            if (!c.dirty) continue;
+            if (options.cancel && options.cancel->check()) break;
+
+            std::vector<int> nodes(c.vertices.begin(), c.vertices.end());
+            std::vector<int> edges;
+            for (int u : c.vertices)
+                for (int w : adj[u])
+                    if (u < w) {
+                        edges.push_back(u);
+                        edges.push_back(w);
+                    }
+            std::shared_ptr<const CsrGraph> csr = std::make_shared<CsrGraph>(
+                CsrGraph::fromIds(nodes.data(), nodes.size(), edges.data(), edges.size() / 2));
+
+            RunOptions componentOptions = options;
+            int key = it->first;
+            int width = this->width(c);
+            if (options.onProgress) {
+                componentOptions.onProgress = [&, key](const Tree &tree) {
+                    Component improved;
+                    fromTree(tree, csr->idOf, improved);
+                    if (this->width(improved) >= width) return;
+                    Tree *whole = glue(idOf, key, &improved);
+                    options.onProgress(*whole);
+                    delete whole;
+                };
+            }
+            Tree *tree = ::decompose(csr, componentOptions);
+            Component fresh;
+            fromTree(*tree, csr->idOf, fresh);
+            c.lowerBound = std::max(c.lowerBound, tree->lowerBound);
+            delete tree;
+            if (this->width(fresh) < width) {
+                c.bags.swap(fresh.bags);
+                c.edges.swap(fresh.edges);
+            }
+            c.dirty = options.cancel && options.cancel->cancelled();
+        }
+        return glue(idOf, -1, nullptr);
+    }
+
+   private:
+    struct Component {
+        std::set<int> vertices;
+        std::vector<std::set<int>> bags;
+        std::vector<std::pair<int, int>> edges;  // between bag indices
+        // a component no path has set up yet has no bound and no tree
+        int lowerBound = 0;
+        bool dirty = true;
+    };
+
+    std::map<int, std::set<int>> adj;
+    std::map<int, int> componentOf;
+    std::map<int, Component> components;
+    int nextComponent;
+
+    static int width(const Component &c) {
+        int widthPlusOne = 0;
+        for (size_t b = 0; b < c.bags.size(); b++)
+            widthPlusOne = std::max(widthPlusOne, (int)c.bags[b].size());
+        return widthPlusOne - 1;
+    }
+
+    static int bagWith(const Component &c, int v) {
+        for (size_t b = 0; b < c.bags.size(); b++)
+            if (c.bags[b].count(v)) return b;
+        return 0;
+    }
+
+    // bags on the tree path from bag a to bag b, both included
+    static std::vector<int> treePath(const Component &c, int a, int b) {
+        std::vector<std::vector<int>> tree(c.bags.size());
+        for (size_t e = 0; e < c.edges.size(); e++) {
+            tree[c.edges[e].first].push_back(c.edges[e].second);
+            tree[c.edges[e].second].push_back(c.edges[e].first);
+        }
+        std::vector<int> parent(c.bags.size(), -1), queue(1, a);
+        parent[a] = a;
+        for (size_t q = 0; q < queue.size() && parent[b] < 0; q++)
+            for (int next : tree[queue[q]])
+                if (parent[next] < 0) {
+                    parent[next] = queue[q];
+                    queue.push_back(next);
+                }
+        std::vector<int> path(1, b);
+        while (path.back() != a)
+            path.push_back(parent[path.back()]);
+        return path;
+    }
+
+    // Joins component b into component a with a tree edge between a bag
+    // holding u and one holding v; the result is a tree of both, short of
+    // the edge u-v. Returns the key of the joined component.
+    int merge(int a, int b, int u, int v) {
+        if (components[a].vertices.size() < components[b].vertices.size()) {
+            std::swap(a, b);
+            std::swap(u, v);
+        }
+        Component &into = components[a];
+        Component &from = components[b];
+        int offset = into.bags.size();
+        into.edges.push_back(std::make_pair(bagWith(into, u), offset + bagWith(from, v)));
+        for (size_t e = 0; e < from.edges.size(); e++)
+            into.edges.push_back(std::make_pair(from.edges[e].first + offset, from.edges[e].second + offset));
+        into.bags.insert(into.bags.end(), from.bags.begin(), from.bags.end());
+        for (int x : from.vertices) {
+            into.vertices.insert(x);
+            componentOf[x] = a;
+        }
+        into.lowerBound = std::max(into.lowerBound, from.lowerBound);
+        into.dirty = into.dirty || from.dirty;
+        components.erase(b);
+        return a;
+    }
+
+    // Replaces component key by one component per connected piece of what
+    // is left of it, each dirty with no lower bound, unless it is still in
+    // one piece and rebuild is off.
+    void split(int key, bool rebuild) {
+        std::set<int> left(components[key].vertices);
+        std::vector<std::vector<int>> pieces;
+        while (!left.empty()) {
+            std::vector<int> queue(1, *left.begin());
+            left.erase(left.begin());
+            for (size_t q = 0; q < queue.size(); q++)
+                for (int u : adj[queue[q]])
+                    if (left.erase(u)) queue.push_back(u);
+            pieces.push_back(queue);
+        }
+        if (pieces.size() == 1 && !rebuild) return;
+
+        Component old;
+        std::swap(old, components[key]);
+        components.erase(key);
+        for (size_t p = 0; p < pieces.size(); p++) {
+            Component &piece = components[nextComponent];
+            piece.vertices.insert(pieces[p].begin(), pieces[p].end());
+            piece.lowerBound = 0;
+            piece.dirty = true;
+            for (int x : pieces[p])
+                componentOf[x] = nextComponent;
+            nextComponent++;
+        }
+        shareBags(old);
+    }
+
+    // Hands the bags of c out to the components their vertices belong to
+    // now (vertices without one are dropped), in one walk down c's tree.
+    // A bag gives each of those components its share, hung under the share
+    // the nearest bag above gave it. The bags holding any one vertex stay
+    // connected, as each but the topmost has its tree parent right above it.
+    // A component reached through bags of its own only at separate places
+    // gets those places joined at its first bag.
+    void shareBags(const Component &c) {
+        int count = c.bags.size();
+        std::vector<std::vector<int>> tree(count);
+        for (size_t e = 0; e < c.edges.size(); e++) {
+            tree[c.edges[e].first].push_back(c.edges[e].second);
+            tree[c.edges[e].second].push_back(c.edges[e].first);
+        }
+        // above[key]: the shares of component key on the path from bag 0 to
+        // the current bag; entered[b]: the components bag b gave shares to
+        std::map<int, std::vector<int>> above;
+        std::vector<std::vector<int>> entered(count);
+        std::vector<char> seen(count, 0);
+        // a bag once to enter it and once more (negative) to leave it
+        std::vector<int> stack(1, 0);
+        seen[0] = 1;
+        while (!stack.empty()) {
+            int b = stack.back();
+            stack.pop_back();
+            if (b < 0) {
+                for (int key : entered[~b])
+                    above[key].pop_back();
+                continue;
+            }
+            std::map<int, std::set<int>> shares;
+            for (int x : c.bags[b]) {
+                std::map<int, int>::const_iterator it = componentOf.find(x);
+                if (it != componentOf.end()) shares[it->second].insert(x);
+            }
+            for (std::map<int, std::set<int>>::iterator it = shares.begin(); it != shares.end(); it++) {
+                Component &to = components[it->first];
+                std::vector<int> &path = above[it->first];
+                int at = to.bags.size();
+                if (!path.empty())
+                    to.edges.push_back(std::make_pair(path.back(), at));
+                else if (at > 0)
+                    to.edges.push_back(std::make_pair(0, at));
+                to.bags.push_back(it->second);
+                path.push_back(at);
+                entered[b].push_back(it->first);
+            }
+            stack.push_back(~b);
+            for (int next : tree[b])
+                if (!seen[next]) {
+                    seen[next] = 1;
+                    stack.push_back(next);
+                }
+        }
+    }
+
+    // bags of tree over idOf in caller ids
+    static void fromTree(const Tree &tree, const std::vector<int> &idOf, Component &c) {
+        c.bags.clear();
+        for (size_t b = 0; b < tree.bag.size(); b++) {
+            std::set<int> bag;
+            for (int x : tree.bag[b])
+                bag.insert(idOf[x]);
+            c.bags.push_back(bag);
+        }
+        c.edges = tree.treeEdge;
+    }
+
+    // Tree of the whole graph over the dense ids of idOf, with replacement
+    // standing in for component key if set. More than one component is glued
+    // as Tree::computeBigTree does.
+    Tree *glue(const std::vector<int> &idOf, int key, const Component *replacement) const {
+        std::vector<Tree *> trees;
+        int lowerBound = 0;
+        for (std::map<int, Component>::const_iterator it = components.begin(); it != components.end(); it++) {
+            const Component &c = it->first == key ? *replacement : it->second;
+            Tree *tree = new Tree(c.vertices.size());
+            for (size_t b = 0; b < c.bags.size(); b++) {
+                std::set<int> bag;
+                for (int x : c.bags[b])
+                    bag.insert(std::lower_bound(idOf.begin(), idOf.end(), x) - idOf.begin());
+                tree->bag.push_back(bag);
+            }
+            tree->treeEdge = c.edges;
+            tree->numberOfBags = tree->bag.size();
+            trees.push_back(tree);
+            lowerBound = std::max(lowerBound, it->second.lowerBound);
+        }
+
+        Tree *whole = new Tree(idOf.size());
+        if (trees.size() == 1) {
+            *whole = *trees[0];
+            whole->numberOfVertices = idOf.size();
+        } else if (!trees.empty()) {
+            whole->computeBigTree(trees);
+        }
+        whole->lowerBound = lowerBound;
+        for (size_t i = 0; i < trees.size(); i++)
+            delete trees[i];
+        return whole;
+    }
+};
+
+#endif
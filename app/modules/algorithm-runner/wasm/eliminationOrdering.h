@@ -0,0 +1,356 @@
+#ifndef ELIMINATION_ORDERING_H
+#define ELIMINATION_ORDERING_H
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "cancelToken.h"
+
+// How runTreeWidth triangulates the graph. CHORDLESS_CYCLES is the original
+// randomised ChordlessCycles/kill_cycles scheme; the others are the greedy
+// elimination heuristics of EliminationOrdering.
+enum EliminationStrategy {
+    CHORDLESS_CYCLES = 0,
+    MIN_DEGREE = 1,
+    MIN_FILL = 2,
+    MIN_WIDTH = 3
+};
+
+// Vertices keyed by a small integer (0..maxKey) in doubly linked buckets.
+// The minimum pointer only moves down on insert, so popMin is amortised O(1)
+// for the degree-like keys used here.
+class BucketQueue {
+   public:
+    BucketQueue(int n, int maxKey) : head(maxKey + 1, -1), prev(n, -1), next(n, -1), key(n, -1) {
+        minKey = maxKey + 1;
+    }
+
+    bool contains(int v) const {
+        return key[v] >= 0;
+    }
+
+    void insert(int v, int k) {
+        key[v] = k;
+        prev[v] = -1;
+        next[v] = head[k];
+        if (head[k] != -1) prev[head[k]] = v;
+        head[k] = v;
+        if (k < minKey) minKey = k;
+    }
+
+    void remove(int v) {
+        int k = key[v];
+        if (prev[v] != -1)
+            next[prev[v]] = next[v];
+        else
+            head[k] = next[v];
+        if (next[v] != -1) prev[next[v]] = prev[v];
+        key[v] = -1;
+    }
+
+    void update(int v, int k) {
+        remove(v);
+        insert(v, k);
+    }
+
+    // -1 when empty
+    int popMin() {
+        while (minKey < (int)head.size() && head[minKey] == -1)
+            minKey++;
+        if (minKey == (int)head.size()) return -1;
+        int v = head[minKey];
+        remove(v);
+        return v;
+    }
+
+   private:
+    std::vector<int> head, prev, next, key;
+    int minKey;
+};
+
+// Binary min-heap of vertices with an index per vertex, ordered by a caller
+// supplied comparison so keys can be updated in place.
+template <typename Less>
+class IndexedHeap {
+   public:
+    IndexedHeap(int n, Less less) : where(n, -1), less(less) {
+    }
+
+    bool empty() const {
+        return heap.empty();
+    }
+
+    bool contains(int v) const {
+        return where[v] >= 0;
+    }
+
+    void insert(int v) {
+        where[v] = heap.size();
+        heap.push_back(v);
+        siftUp(where[v]);
+    }
+
+    // restore the heap after v's key changed in either direction
+    void update(int v) {
+        siftUp(where[v]);
+        siftDown(where[v]);
+    }
+
+    int popMin() {
+        int v = heap[0];
+        swapAt(0, heap.size() - 1);
+        heap.pop_back();
+        where[v] = -1;
+        if (!heap.empty()) siftDown(0);
+        return v;
+    }
+
+   private:
+    std::vector<int> heap, where;
+    Less less;
+
+    void swapAt(int i, int j) {
+        std::swap(heap[i], heap[j]);
+        where[heap[i]] = i;
+        where[heap[j]] = j;
+    }
+
+    void siftUp(int i) {
+        while (i > 0 && less(heap[i], heap[(i - 1) / 2])) {
+            swapAt(i, (i - 1) / 2);
+            i = (i - 1) / 2;
+        }
+    }
+
+    void siftDown(int i) {
+        int size = heap.size();
+        while (true) {
+            int best = i, l = 2 * i + 1, r = 2 * i + 2;
+            if (l < size && less(heap[l], heap[best])) best = l;
+            if (r < size && less(heap[r], heap[best])) best = r;
+            if (best == i) return;
+            swapAt(i, best);
+            i = best;
+        }
+    }
+};
+
+// Greedy elimination game. Works on its own copy of the graph (sorted
+// adjacency vectors over dense ids), repeatedly picks a vertex by the chosen
+// heuristic, turns its remaining neighbourhood into a clique and removes it.
+// The result is an elimination ordering (ordering[0] eliminated first), the
+// fill edges that make the graph chordal for it, and the width it achieves.
+class EliminationOrdering {
+   public:
+    std::vector<int> ordering;
+    std::vector<std::pair<int, int>> fillEdges;
+    int width;
+
+    template <typename G>
+    EliminationOrdering(const G &g, const std::vector<int> &nodes) : adj(g.n), fill(g.n, 0) {
+        this->nodes = nodes;
+        width = -1;
+        interrupted = nullptr;
+        stopped = false;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            int v = nodes[i];
+            g.forEachNeighbour(v, [&](int u) { adj[v].push_back(u); });
+            std::sort(adj[v].begin(), adj[v].end());
+        }
+    }
+
+    // interrupted, if set, is polled for every pair a step joins: one step
+    // late in a dense graph can take seconds. False, with ordering and
+    // fillEdges empty, when it fired before the ordering was done.
+    bool run(EliminationStrategy strategy, CancelCheck *interrupted = nullptr) {
+        this->interrupted = interrupted;
+        ordering.reserve(nodes.size());
+        if (strategy == MIN_FILL)
+            runMinFill();
+        else if (strategy == MIN_WIDTH)
+            runMinWidth();
+        else
+            runMinDegree();
+        if (!stopped) return true;
+        ordering.clear();
+        fillEdges.clear();
+        width = -1;
+        return false;
+    }
+
+   private:
+    std::vector<int> nodes;
+    std::vector<std::vector<int>> adj;
+    std::vector<long long> fill;  // non-adjacent neighbour pairs, kept only by MIN_FILL
+    CancelCheck *interrupted;
+    bool stopped;
+
+    // true from the first time interrupted fires on
+    bool cut() {
+        if (!stopped && interrupted && (*interrupted)()) stopped = true;
+        return stopped;
+    }
+
+    bool adjacent(int a, int b) const {
+        return std::binary_search(adj[a].begin(), adj[a].end(), b);
+    }
+
+    void insertSorted(std::vector<int> &row, int x) {
+        row.insert(std::lower_bound(row.begin(), row.end(), x), x);
+    }
+
+    void eraseSorted(std::vector<int> &row, int x) {
+        row.erase(std::lower_bound(row.begin(), row.end(), x));
+    }
+
+    // Eliminate v and append every vertex whose key may have changed to
+    // touched. With trackFill the fill counts are updated exactly.
+    void eliminate(int v, bool trackFill, std::vector<int> &touched) {
+        const std::vector<int> &nb = adj[v];
+        int d = nb.size();
+        width = std::max(width, d);
+        ordering.push_back(v);
+
+        std::vector<int> common;
+        for (int i = 0; i < d; i++) {
+            for (int j = i + 1; j < d; j++) {
+                // half an elimination is of no use, nor is anything after it
+                if (cut()) return;
+                int a = nb[i], b = nb[j];
+                if (adjacent(a, b)) continue;
+                if (trackFill) {
+                    // the pair (a, b) stops counting for their common
+                    // neighbours, and each endpoint gains one pair per
+                    // neighbour the other endpoint does not see
+                    common.clear();
+                    std::set_intersection(adj[a].begin(), adj[a].end(), adj[b].begin(), adj[b].end(), std::back_inserter(common));
+                    for (size_t c = 0; c < common.size(); c++) {
+                        if (common[c] == v) continue;
+                        fill[common[c]]--;
+                        touched.push_back(common[c]);
+                    }
+                    fill[a] += adj[a].size() - common.size();
+                    fill[b] += adj[b].size() - common.size();
+                }
+                insertSorted(adj[a], b);
+                insertSorted(adj[b], a);
+                fillEdges.push_back(std::make_pair(a, b));
+            }
+        }
+
+        for (int i = 0; i < d; i++) {
+            int u = nb[i];
+            // N(v) is now a clique, so u only loses the pairs (v, y) with y
+            // outside N(v)
+            if (trackFill) fill[u] -= (long long)adj[u].size() - d;
+            touched.push_back(u);
+            eraseSorted(adj[u], v);
+        }
+        adj[v].clear();
+    }
+
+    void runMinDegree() {
+        BucketQueue queue(adj.size(), nodes.size());
+        for (int i = nodes.size() - 1; i >= 0; i--)
+            queue.insert(nodes[i], adj[nodes[i]].size());
+
+        std::vector<int> touched;
+        int v;
+        while (!cut() && (v = queue.popMin()) != -1) {
+            touched.clear();
+            eliminate(v, false, touched);
+            for (size_t i = 0; i < touched.size(); i++)
+                queue.update(touched[i], adj[touched[i]].size());
+        }
+    }
+
+    struct FillLess {
+        const EliminationOrdering *e;
+        bool operator()(int a, int b) const {
+            if (e->fill[a] != e->fill[b]) return e->fill[a] < e->fill[b];
+            if (e->adj[a].size() != e->adj[b].size()) return e->adj[a].size() < e->adj[b].size();
+            return a < b;
+        }
+    };
+
+    // fill(v) = C(deg v, 2) - triangles through v; triangles are listed once
+    // each by orienting edges from lower to higher (degree, id)
+    void countInitialFill() {
+        std::vector<int> mark(adj.size(), -1);
+        std::vector<long long> triangles(adj.size(), 0);
+        for (size_t i = 0; i < nodes.size(); i++) {
+            int v = nodes[i];
+            for (size_t j = 0; j < adj[v].size(); j++)
+                if (forward(v, adj[v][j])) mark[adj[v][j]] = v;
+            for (size_t j = 0; j < adj[v].size(); j++) {
+                int u = adj[v][j];
+                if (!forward(v, u)) continue;
+                for (size_t k = 0; k < adj[u].size(); k++) {
+                    int w = adj[u][k];
+                    if (forward(u, w) && mark[w] == v) {
+                        triangles[v]++;
+                        triangles[u]++;
+                        triangles[w]++;
+                    }
+                }
+            }
+        }
+        for (size_t i = 0; i < nodes.size(); i++) {
+            long long d = adj[nodes[i]].size();
+            fill[nodes[i]] = d * (d - 1) / 2 - triangles[nodes[i]];
+        }
+    }
+
+    bool forward(int a, int b) const {
+        if (adj[a].size() != adj[b].size()) return adj[a].size() < adj[b].size();
+        return a < b;
+    }
+
+    void runMinFill() {
+        countInitialFill();
+        FillLess less = {this};
+        IndexedHeap<FillLess> heap(adj.size(), less);
+        for (size_t i = 0; i < nodes.size(); i++)
+            heap.insert(nodes[i]);
+
+        std::vector<int> touched;
+        while (!cut() && !heap.empty()) {
+            int v = heap.popMin();
+            touched.clear();
+            eliminate(v, true, touched);
+            for (size_t i = 0; i < touched.size(); i++)
+                heap.update(touched[i]);
+        }
+    }
+
+    // Minimum width (degeneracy) ordering: repeatedly delete a vertex of
+    // minimum degree without adding fill, then play the elimination game
+    // in that order to get the fill edges and width.
+    void runMinWidth() {
+        BucketQueue queue(adj.size(), nodes.size());
+        std::vector<int> degree(adj.size(), 0);
+        for (int i = nodes.size() - 1; i >= 0; i--) {
+            degree[nodes[i]] = adj[nodes[i]].size();
+            queue.insert(nodes[i], degree[nodes[i]]);
+        }
+
+        std::vector<int> order;
+        order.reserve(nodes.size());
+        int v;
+        while ((v = queue.popMin()) != -1) {
+            order.push_back(v);
+            for (size_t i = 0; i < adj[v].size(); i++) {
+                int u = adj[v][i];
+                if (queue.contains(u)) queue.update(u, --degree[u]);
+            }
+        }
+
+        std::vector<int> touched;
+        for (size_t i = 0; i < order.size() && !cut(); i++)
+            eliminate(order[i], false, touched);
+    }
+};
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef EXACT_TREEWIDTH_H
+#define EXACT_TREEWIDTH_H
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "cancelToken.h"
+
+// Exact treewidth of graphs with at most 64 vertices by the dynamic
+// programme of Bodlaender, Fomin, Koster, Kratsch and Thilikos over
+// elimination ordering prefixes. Vertex sets are single words. Eliminating
+// the set S first gives v the degree Q(S, v): the vertices outside S + v
+// that v reaches through S, whatever the order inside S. The decision
+// version for width k grows the prefixes one vertex at a time, layer by
+// layer, keeping those whose every step had Q <= k, and succeeds once at
+// most k + 1 vertices are left. A largest clique found greedily is never
+// eliminated: some optimal ordering ends with any clique.
+//
+// G needs a dense vertex count `n` and `forEachNeighbour(v, f)`; nodes lists
+// the vertices (closed under adjacency, at most 64 of them).
+class ExactTreewidth {
+   public:
+    // once solve() found a width below high: an ordering of that width and
+    // the fill edges that make the graph chordal for it, in the ids of nodes
+    std::vector<int> ordering;
+    std::vector<std::pair<int, int>> fillEdges;
+    int width;
+    // widths solve() ruled out leave this above them, even if it gave up
+    // later; the treewidth is at least lowerBound when low was a lower bound
+    int lowerBound;
+    size_t peakBytes;  // most memory the layers took at once
+
+    template <typename G>
+    ExactTreewidth(const G &g, const std::vector<int> &nodes) : nodes(nodes), adj(nodes.size(), 0) {
+        size = nodes.size();
+        std::vector<int> local(g.n, -1);
+        for (int i = 0; i < size; i++)
+            local[nodes[i]] = i;
+        for (int i = 0; i < size; i++)
+            g.forEachNeighbour(nodes[i], [&](int u) { adj[i] |= bit(local[u]); });
+        width = -1;
+        lowerBound = 0;
+        peakBytes = 0;
+    }
+
+    // Finds the least width in [low, high) the graph has a decomposition of:
+    // true with width and ordering set, or with width = high and no ordering
+    // when there is none. width is the treewidth when low is a lower bound
+    // and a decomposition of width high is known. False once maxBytes of
+    // layers would be needed or interrupted fires.
+    bool solve(int low, int high, size_t maxBytes, CancelCheck *interrupted) {
+        uint64_t clique = greedyClique();
+        lowerBound = std::max(low, __builtin_popcountll(clique) - 1);
+        for (int k = lowerBound; k < high; k++) {
+            int result = decide(k, clique, maxBytes, interrupted);
+            if (result < 0) return false;
+            if (result > 0) {
+                width = k;
+                return true;
+            }
+            lowerBound = k + 1;
+        }
+        width = high;
+        ordering.clear();
+        fillEdges.clear();
+        return true;
+    }
+
+   private:
+    std::vector<int> nodes;
+    std::vector<uint64_t> adj;
+    int size;
+
+    static uint64_t bit(int i) {
+        return uint64_t(1) << i;
+    }
+
+    uint64_t all() const {
+        return size == 64 ? ~uint64_t(0) : bit(size) - 1;
+    }
+
+    // vertices outside S + v that v reaches through S
+    int q(uint64_t s, int v) const {
+        uint64_t seen = bit(v), frontier = bit(v), reach = 0;
+        while (frontier) {
+            int x = __builtin_ctzll(frontier);
+            frontier &= frontier - 1;
+            reach |= adj[x];
+            uint64_t inside = adj[x] & s & ~seen;
+            seen |= inside;
+            frontier |= inside;
+        }
+        return __builtin_popcountll(reach & ~s & ~bit(v));
+    }
+
+    // grows a clique from each vertex by highest degree, keeps the largest
+    uint64_t greedyClique() const {
+        uint64_t best = 0;
+        for (int v = 0; v < size; v++) {
+            uint64_t clique = bit(v), candidates = adj[v];
+            while (candidates) {
+                int pick = -1, pickDegree = -1;
+                for (uint64_t c = candidates; c; c &= c - 1) {
+                    int u = __builtin_ctzll(c);
+                    int degree = __builtin_popcountll(adj[u] & candidates);
+                    if (degree > pickDegree) {
+                        pick = u;
+                        pickDegree = degree;
+                    }
+                }
+                clique |= bit(pick);
+                candidates &= adj[pick];
+            }
+            if (__builtin_popcountll(clique) > __builtin_popcountll(best)) best = clique;
+        }
+        return best;
+    }
+
+    // 1 if width k is possible (ordering set), 0 if not, -1 if it gave up
+    int decide(int k, uint64_t clique, size_t maxBytes, CancelCheck *interrupted) {
+        // layer d holds the feasible prefixes of d vertices, sorted, and the
+        // vertex each one was reached with
+        std::vector<std::vector<uint64_t>> sets(1, std::vector<uint64_t>(1, 0));
+        std::vector<std::vector<char>> last(1, std::vector<char>(1, -1));
+        std::vector<std::pair<uint64_t, char>> next;
+        size_t bytes = sizeof(uint64_t) + 1;
+        uint64_t movable = all() & ~clique;
+
+        while (true) {
+            const std::vector<uint64_t> &layer = sets.back();
+            for (size_t i = 0; i < layer.size(); i++) {
+                if (size - __builtin_popcountll(layer[i]) <= k + 1) {
+                    rebuild(sets, last, i);
+                    return 1;
+                }
+            }
+            next.clear();
+            for (size_t i = 0; i < layer.size(); i++) {
+                if (interrupted && (*interrupted)()) return -1;
+                for (uint64_t c = movable & ~layer[i]; c; c &= c - 1) {
+                    int v = __builtin_ctzll(c);
+                    if (q(layer[i], v) <= k) next.push_back(std::make_pair(layer[i] | bit(v), (char)v));
+                }
+                if (bytes + next.size() * sizeof(next[0]) > maxBytes) return -1;
+            }
+            peakBytes = std::max(peakBytes, bytes + next.size() * sizeof(next[0]));
+            if (next.empty()) return 0;
+
+            std::sort(next.begin(), next.end());
+            sets.push_back(std::vector<uint64_t>());
+            last.push_back(std::vector<char>());
+            for (size_t i = 0; i < next.size(); i++) {
+                if (i > 0 && next[i].first == next[i - 1].first) continue;
+                sets.back().push_back(next[i].first);
+                last.back().push_back(next[i].second);
+            }
+            bytes += sets.back().size() * (sizeof(uint64_t) + 1);
+        }
+    }
+
+    // ordering from the prefix at index at of the last layer: its vertices
+    // walked back to the empty set, then everything left. The elimination
+    // game over it gives the fill edges.
+    void rebuild(const std::vector<std::vector<uint64_t>> &sets, const std::vector<std::vector<char>> &last,
+                 size_t at) {
+        std::vector<int> order;
+        uint64_t prefix = sets.back()[at], s = prefix;
+        for (int d = sets.size() - 1; d > 0; d--) {
+            int v = last[d][at];
+            order.push_back(v);
+            s &= ~bit(v);
+            at = std::lower_bound(sets[d - 1].begin(), sets[d - 1].end(), s) - sets[d - 1].begin();
+        }
+        std::reverse(order.begin(), order.end());
+        for (uint64_t rest = all() & ~prefix; rest; rest &= rest - 1)
+            order.push_back(__builtin_ctzll(rest));
+
+        ordering.clear();
+        fillEdges.clear();
+        std::vector<uint64_t> filled(adj);
+        uint64_t done = 0;
+        for (int i = 0; i < size; i++) {
+            int v = order[i];
+            ordering.push_back(nodes[v]);
+            done |= bit(v);
+            uint64_t later = filled[v] & ~done;
+            for (uint64_t c = later; c; c &= c - 1) {
+                int u = __builtin_ctzll(c);
+                for (uint64_t m = later & ~filled[u] & ~bit(u); m; m &= m - 1) {
+                    int w = __builtin_ctzll(m);
+                    if (u < w) fillEdges.push_back(std::make_pair(nodes[u], nodes[w]));
+                }
+                filled[u] |= later & ~bit(u);
+            }
+        }
+    }
+};
+
+#endif
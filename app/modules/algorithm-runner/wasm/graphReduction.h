@@ -0,0 +1,240 @@
+#ifndef GRAPH_REDUCTION_H
+#define GRAPH_REDUCTION_H
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "csrGraph.h"
+
+// Treewidth-safe preprocessing after Bodlaender and Koster. A lower bound
+// low is kept while vertices are removed by the rules
+//
+//   simplicial         N(v) is a clique; low becomes max(low, deg v). The
+//                      islet (deg 0) and twig (deg 1) rules are the small
+//                      cases of this one.
+//   almost simplicial  N(v) is a clique but for one vertex and deg v <= low;
+//                      N(v) is made a clique. Covers series (deg 2) and
+//                      triangle (deg 3 with an edge inside N(v)).
+//   buddy              v and w have degree 3, the same neighbours and
+//                      low >= 3; both go and N(v) is made a clique.
+//
+// When no rule applies, low is raised to the minimum degree of what is left
+// and the rules run again. Each removal keeps tw = max(low, tw(rest)), so a
+// decomposition of the kernel lifts back to the input by giving every removed
+// vertex v the bag N[v], hung under a bag that holds N(v) (a clique once v
+// is gone), last removed first.
+class GraphReduction {
+   public:
+    // a lower bound on the treewidth of the input
+    int lowerBound;
+    // the rest, over its own dense ids; kernel->idOf maps them to dense ids
+    // of the input. n == 0 when the rules took the whole graph.
+    std::shared_ptr<const CsrGraph> kernel;
+
+    explicit GraphReduction(const CsrGraph &g) : adj(g.n), removed(g.n, 0), queued(g.n, 0) {
+        lowerBound = 0;
+        alive = g.n;
+        stepOffsets.push_back(0);
+        for (int v = 0; v < g.n; v++)
+            adj[v].assign(g.begin(v), g.end(v));
+
+        while (true) {
+            for (int v = 0; v < g.n; v++)
+                if (!removed[v]) push(v);
+            while (!queue.empty()) {
+                int v = queue.back();
+                queue.pop_back();
+                queued[v] = 0;
+                if (!removed[v]) reduce(v);
+            }
+            if (alive == 0) break;
+            int minDegree = std::numeric_limits<int>::max();
+            for (int v = 0; v < g.n; v++)
+                if (!removed[v]) minDegree = std::min(minDegree, (int)adj[v].size());
+            if (minDegree <= lowerBound) break;
+            lowerBound = minDegree;
+        }
+
+        std::vector<int> ids, index(g.n, -1);
+        for (int v = 0; v < g.n; v++) {
+            if (removed[v]) continue;
+            index[v] = ids.size();
+            ids.push_back(v);
+        }
+        std::vector<std::pair<int, int>> edges;
+        for (size_t i = 0; i < ids.size(); i++)
+            for (size_t j = 0; j < adj[ids[i]].size(); j++)
+                if (adj[ids[i]][j] > ids[i]) edges.push_back(std::make_pair(i, index[adj[ids[i]][j]]));
+        kernel = std::make_shared<CsrGraph>(ids, edges);
+        std::vector<std::vector<int>>().swap(adj);
+    }
+
+    // vertices the rules removed
+    int removedCount() const {
+        return stepVertex.size();
+    }
+
+    // Decomposition of the input from one of the kernel (bags in kernel
+    // dense ids). Its width is max(kernel width, lowerBound).
+    void lift(const std::vector<std::set<int>> &bags, const std::vector<std::pair<int, int>> &edges,
+              std::vector<std::set<int>> &liftedBags, std::vector<std::pair<int, int>> &liftedEdges) const {
+        liftedBags.clear();
+        liftedEdges = edges;
+        std::vector<std::vector<int>> bagsOf(removed.size());
+        for (size_t b = 0; b < bags.size(); b++) {
+            std::set<int> bag;
+            for (int x : bags[b]) {
+                bag.insert(kernel->idOf[x]);
+                bagsOf[kernel->idOf[x]].push_back(b);
+            }
+            liftedBags.push_back(bag);
+        }
+
+        for (int i = (int)stepVertex.size() - 1; i >= 0; i--) {
+            int v = stepVertex[i];
+            const int *begin = stepNeighbours.data() + stepOffsets[i];
+            const int *end = stepNeighbours.data() + stepOffsets[i + 1];
+            int parent = holding(begin, end, liftedBags, bagsOf);
+            // a bag that is exactly N(v) takes v itself
+            if (parent >= 0 && (int)liftedBags[parent].size() == end - begin) {
+                liftedBags[parent].insert(v);
+                bagsOf[v].push_back(parent);
+                continue;
+            }
+            int at = liftedBags.size();
+            if (parent >= 0) liftedEdges.push_back(std::make_pair(parent, at));
+            std::set<int> bag(begin, end);
+            bag.insert(v);
+            for (int x : bag)
+                bagsOf[x].push_back(at);
+            liftedBags.push_back(bag);
+        }
+    }
+
+   private:
+    std::vector<std::vector<int>> adj;  // sorted rows over the input's dense ids
+    std::vector<char> removed, queued;
+    std::vector<int> queue;
+    int alive;
+    // removal i took stepVertex[i] with the neighbours
+    // stepNeighbours[stepOffsets[i] .. stepOffsets[i + 1])
+    std::vector<int> stepVertex, stepOffsets, stepNeighbours;
+
+    bool adjacent(int a, int b) const {
+        if (adj[a].size() > adj[b].size()) std::swap(a, b);
+        return std::binary_search(adj[a].begin(), adj[a].end(), b);
+    }
+
+    void push(int v) {
+        if (queued[v]) return;
+        queued[v] = 1;
+        queue.push_back(v);
+    }
+
+    // Applies the first rule that fits v, if any.
+    void reduce(int v) {
+        const std::vector<int> &nb = adj[v];
+        int d = nb.size();
+        // every missing edge inside N(v) has to touch the same vertex for v
+        // to be almost simplicial; centre holds the (at most two) candidates
+        int missing = 0;
+        int centre[2] = {-1, -1};
+        bool candidate = true;
+        for (int i = 0; i < d && candidate; i++) {
+            for (int j = i + 1; j < d && candidate; j++) {
+                if (adjacent(nb[i], nb[j])) continue;
+                if (missing++ == 0) {
+                    centre[0] = nb[i];
+                    centre[1] = nb[j];
+                } else {
+                    for (int c = 0; c < 2; c++)
+                        if (centre[c] != nb[i] && centre[c] != nb[j]) centre[c] = -1;
+                }
+                // with an edge missing only almost simplicial is left
+                candidate = d <= lowerBound && (centre[0] >= 0 || centre[1] >= 0);
+            }
+        }
+
+        if (missing == 0) {
+            lowerBound = std::max(lowerBound, d);
+            eliminate(v);
+        } else if (candidate) {
+            eliminate(v);
+        } else if (d == 3 && lowerBound >= 3) {
+            for (size_t j = 0; j < adj[nb[0]].size(); j++) {
+                int w = adj[nb[0]][j];
+                if (w != v && adj[w] == nb) {
+                    eliminate(v);
+                    // w now has a clique of three for neighbours
+                    eliminate(w);
+                    return;
+                }
+            }
+        }
+    }
+
+    // Removes v, makes N(v) a clique and queues every vertex whose
+    // neighbourhood changed with it.
+    void eliminate(int v) {
+        std::vector<int> nb;
+        nb.swap(adj[v]);
+        stepVertex.push_back(v);
+        stepNeighbours.insert(stepNeighbours.end(), nb.begin(), nb.end());
+        stepOffsets.push_back(stepNeighbours.size());
+        removed[v] = 1;
+        alive--;
+
+        for (size_t i = 0; i < nb.size(); i++) {
+            std::vector<int> &row = adj[nb[i]];
+            row.erase(std::lower_bound(row.begin(), row.end(), v));
+            push(nb[i]);
+        }
+        for (size_t i = 0; i < nb.size(); i++) {
+            for (size_t j = i + 1; j < nb.size(); j++) {
+                int a = nb[i], b = nb[j];
+                if (adjacent(a, b)) continue;
+                adj[a].insert(std::lower_bound(adj[a].begin(), adj[a].end(), b), b);
+                adj[b].insert(std::lower_bound(adj[b].begin(), adj[b].end(), a), a);
+                // a new edge can complete the neighbourhood of a common neighbour
+                std::vector<int>::const_iterator x = adj[a].begin(), y = adj[b].begin();
+                while (x != adj[a].end() && y != adj[b].end()) {
+                    if (*x < *y) {
+                        x++;
+                    } else if (*y < *x) {
+                        y++;
+                    } else {
+                        push(*x);
+                        x++;
+                        y++;
+                    }
+                }
+            }
+        }
+    }
+
+    // a lifted bag that contains all of [begin, end), bag 0 for an empty
+    // range, -1 if there are no bags yet
+    static int holding(const int *begin, const int *end, const std::vector<std::set<int>> &bags,
+                       const std::vector<std::vector<int>> &bagsOf) {
+        if (bags.empty()) return -1;
+        if (begin == end) return 0;
+        const int *rarest = begin;
+        for (const int *it = begin; it != end; it++)
+            if (bagsOf[*it].size() < bagsOf[*rarest].size()) rarest = it;
+        const std::vector<int> &candidates = bagsOf[*rarest];
+        for (size_t c = 0; c < candidates.size(); c++) {
+            const std::set<int> &bag = bags[candidates[c]];
+            bool all = true;
+            for (const int *it = begin; it != end && all; it++)
+                all = bag.count(*it) > 0;
+            if (all) return candidates[c];
+        }
+        return -1;
+    }
+};
+
+#endif
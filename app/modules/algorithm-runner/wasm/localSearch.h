@@ -0,0 +1,287 @@
+#ifndef LOCAL_SEARCH_H
+#define LOCAL_SEARCH_H
+
+#include <math.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "cancelToken.h"
+
+// Simulated annealing over elimination orderings (after Kjaerulff). A move
+// shifts one vertex a few places by swapping neighbours in the ordering, and
+// every swap updates the filled graph in place instead of replaying the
+// elimination game.
+//
+// Swapping u = order[i] and w = order[i + 1] changes nothing unless they are
+// adjacent in the filled graph. If they are, S = higher(w) is the same set
+// in both orders and becomes a clique either way, so only u and w change.
+// The new higher(w) is u plus the x in S that were adjacent to w before step
+// i. The new higher(u) is S. Every arc (a, b) of the filled graph carries
+// its support: 1 for an input edge plus one per earlier vertex whose
+// neighbourhood holds both ends. "Adjacent before step i" is then "not
+// supported by u alone", and a swap costs O(|S|) plus O(|S|) per arc it
+// creates or drops.
+//
+// The search minimises the width, then the number of vertices at that
+// width, then the fill. G needs a dense vertex count `n` and
+// `forEachNeighbour(v, f)`.
+class LocalSearch {
+   public:
+    std::vector<int> best;  // best ordering seen, best[0] eliminated first
+    int bestWidth;
+
+    // ordering: every vertex of the graph to search, first eliminated first
+    template <typename G>
+    LocalSearch(const G &g, const std::vector<int> &ordering)
+        : order(ordering), pos(g.n, -1), higher(g.n), flag(g.n, 0), histogram(ordering.size() + 1, 0) {
+        int size = order.size();
+        for (int i = 0; i < size; i++)
+            pos[order[i]] = i;
+        long long edges = 0;
+        for (int i = 0; i < size; i++) {
+            int v = order[i];
+            g.forEachNeighbour(v, [&](int x) {
+                if (pos[x] > i) higher[v].push_back(Arc{x, 1, 1});
+            });
+            std::sort(higher[v].begin(), higher[v].end(), byVertex);
+            higher[v].erase(std::unique(higher[v].begin(), higher[v].end(), sameVertex), higher[v].end());
+            edges += higher[v].size();
+        }
+        // the elimination game: each neighbourhood becomes a clique
+        std::vector<int> clique;
+        for (int i = 0; i < size; i++) {
+            int v = order[i];
+            clique.clear();
+            for (size_t j = 0; j < higher[v].size(); j++)
+                clique.push_back(higher[v][j].to);
+            for (size_t a = 0; a < clique.size(); a++)
+                for (size_t b = a + 1; b < clique.size(); b++)
+                    support(clique[a], clique[b], 1);
+        }
+        fill = -edges;
+        width = 0;
+        for (int i = 0; i < size; i++) {
+            int d = higher[order[i]].size();
+            fill += d;
+            histogram[d]++;
+            width = std::max(width, d);
+        }
+        best = order;
+        bestWidth = width;
+    }
+
+    // fill edges of the current ordering
+    std::vector<std::pair<int, int>> fillEdges() const {
+        std::vector<std::pair<int, int>> ret;
+        for (size_t i = 0; i < order.size(); i++) {
+            int v = order[i];
+            for (size_t j = 0; j < higher[v].size(); j++)
+                if (!higher[v][j].original) ret.push_back(std::make_pair(v, higher[v][j].to));
+        }
+        return ret;
+    }
+
+    // Anneals for budgetMs milliseconds, or until the best width reaches
+    // lowerBound or cancel fires. onImprove (if set) is called each time
+    // bestWidth drops, with best already updated.
+    void run(double budgetMs, int lowerBound, unsigned int seed, CancelToken *cancel,
+             const std::function<void()> &onImprove) {
+        int size = order.size();
+        if (size < 3 || bestWidth <= lowerBound) return;
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> coin(0, 1);
+        CancelCheck interrupted(cancel);
+        Clock::time_point start = Clock::now();
+        double energy = currentEnergy(), bestEnergy = energy;
+        // a move that puts one more vertex at the width is taken with
+        // probability exp(-1 / temperature); the temperature falls
+        // geometrically from HOT to COLD over the budget
+        double temperature = HOT;
+        int shiftLimit = std::min(size - 1, MAX_SHIFT);
+        std::vector<int> swaps;
+
+        for (long long move = 0;; move++) {
+            if ((move & 63) == 0) {
+                double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                if (elapsed >= budgetMs) break;
+                temperature = HOT * pow(COLD / HOT, elapsed / budgetMs);
+            }
+            if (interrupted()) break;
+
+            // half the moves go to a vertex at the width, if one turns up
+            int from = rng() % size;
+            if (rng() & 1) {
+                for (int tries = 0; tries < 16 && (int)higher[order[from]].size() < width; tries++)
+                    from = rng() % size;
+            }
+            int distance = 1 + rng() % shiftLimit;
+            int to = (rng() & 1) ? std::min(size - 1, from + distance) : std::max(0, from - distance);
+            if (to == from) continue;
+
+            swaps.clear();
+            for (int i = from; i < to; i++) {
+                swap(i);
+                swaps.push_back(i);
+            }
+            for (int i = from - 1; i >= to; i--) {
+                swap(i);
+                swaps.push_back(i);
+            }
+            double next = currentEnergy();
+            if (next <= energy || coin(rng) < exp((energy - next) / temperature)) {
+                energy = next;
+                if (energy < bestEnergy) {
+                    bestEnergy = energy;
+                    best = order;
+                    if (width < bestWidth) {
+                        bestWidth = width;
+                        if (onImprove) onImprove();
+                        if (bestWidth <= lowerBound) break;
+                    }
+                }
+                continue;
+            }
+            for (int s = swaps.size() - 1; s >= 0; s--)
+                swap(swaps[s]);
+        }
+    }
+
+   private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Arc {
+        int to;
+        int support;
+        char original;  // an input edge, never dropped
+    };
+
+    static constexpr int MAX_SHIFT = 32;
+    static constexpr double HOT = 3.0, COLD = 0.05;
+
+    std::vector<int> order, pos;
+    std::vector<std::vector<Arc>> higher;  // arcs to later vertices, sorted by vertex
+    std::vector<char> flag;                // scratch of swap, 0 outside it
+    std::vector<int> histogram;            // vertices per higher degree
+    int width;
+    long long fill;
+
+    static bool byVertex(const Arc &a, const Arc &b) {
+        return a.to < b.to;
+    }
+
+    static bool sameVertex(const Arc &a, const Arc &b) {
+        return a.to == b.to;
+    }
+
+    static std::vector<Arc>::iterator find(std::vector<Arc> &row, int x) {
+        std::vector<Arc>::iterator it = std::lower_bound(row.begin(), row.end(), Arc{x, 0, 0}, byVertex);
+        return it != row.end() && it->to == x ? it : row.end();
+    }
+
+    // adds delta to the support of arc (a, b), creating it if need be
+    void support(int a, int b, int delta) {
+        if (pos[a] > pos[b]) std::swap(a, b);
+        std::vector<Arc> &row = higher[a];
+        std::vector<Arc>::iterator it = std::lower_bound(row.begin(), row.end(), Arc{b, 0, 0}, byVertex);
+        if (it != row.end() && it->to == b)
+            it->support += delta;
+        else
+            row.insert(it, Arc{b, delta, 0});
+    }
+
+    // width first, then vertices at the width, then fill, which is below
+    // size^2 / 2
+    double currentEnergy() const {
+        double size = order.size();
+        return (double)width * size + histogram[width] + fill / (size * size);
+    }
+
+    void setDegree(int before, int after) {
+        histogram[before]--;
+        histogram[after]++;
+        if (after > width) width = after;
+        while (histogram[width] == 0)
+            width--;
+    }
+
+    // Swaps order[i] and order[i + 1]; its own inverse.
+    void swap(int i) {
+        int u = order[i], w = order[i + 1];
+        order[i] = w;
+        order[i + 1] = u;
+        pos[w] = i;
+        pos[u] = i + 1;
+        std::vector<Arc> &hu = higher[u], &hw = higher[w];
+        std::vector<Arc>::iterator uw = find(hu, w);
+        if (uw == hu.end()) return;
+
+        // x in S = hw is KEEP in both new rows, DROP when only u supported
+        // (w, x), NEW when (u, x) did not exist
+        const char KEEP = 1, DROP = 2, NEW = 3;
+        Arc wu = *uw;
+        wu.to = u;
+        std::vector<Arc> rowU, rowW;
+        rowU.reserve(hw.size());
+        rowW.reserve(hw.size() + 1);
+        std::vector<int> changed;
+        size_t j = 0;
+        bool placed = false;
+        for (size_t k = 0; k < hw.size(); k++) {
+            const Arc &x = hw[k];
+            while (j < hu.size() && hu[j].to < x.to)
+                j++;
+            if (!placed && u < x.to) {
+                rowW.push_back(wu);
+                placed = true;
+            }
+            if (j < hu.size() && hu[j].to == x.to) {
+                if (x.support >= 2) {
+                    flag[x.to] = KEEP;
+                    rowW.push_back(Arc{x.to, x.support - 1, x.original});
+                    rowU.push_back(Arc{x.to, hu[j].support + 1, hu[j].original});
+                } else {
+                    flag[x.to] = DROP;
+                    changed.push_back(x.to);
+                    rowU.push_back(hu[j]);
+                }
+            } else {
+                flag[x.to] = NEW;
+                changed.push_back(x.to);
+                rowW.push_back(x);
+                rowU.push_back(Arc{x.to, 1, 0});
+            }
+        }
+        if (!placed) rowW.push_back(wu);
+
+        // arcs inside S: w supports the pairs in its new row, u no longer
+        // supports the pairs of its old one
+        long long dropped = 0, added = 0;
+        for (size_t c = 0; c < changed.size(); c++) {
+            int a = changed[c];
+            if (flag[a] == DROP) dropped++;
+            else added++;
+            for (size_t k = 0; k < hw.size(); k++) {
+                int b = hw[k].to;
+                if (b == a || (flag[b] == flag[a] && b < a)) continue;
+                if (flag[a] == DROP && flag[b] != NEW) support(a, b, -1);
+                if (flag[a] == NEW && flag[b] != DROP) support(a, b, 1);
+            }
+        }
+        for (size_t k = 0; k < hw.size(); k++)
+            flag[hw[k].to] = 0;
+        fill += added - dropped;
+
+        int degreeU = hu.size(), degreeW = hw.size();
+        hu.swap(rowU);
+        hw.swap(rowW);
+        setDegree(degreeU, higher[u].size());
+        setDegree(degreeW, higher[w].size());
+    }
+};
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef LOWER_BOUNDS_H
+#define LOWER_BOUNDS_H
+
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
+// Treewidth lower bounds after Gogate and Dechter (minor-min-width) and
+// Bodlaender, Koster and Wolle, "Contraction and Treewidth Lower Bounds".
+// Each is the largest minimum degree seen while taking the graph apart into
+// smaller minors; they differ only in how it is taken apart. G needs a dense
+// vertex count `n`, `degree(v)` and `forEachNeighbour(v, f)` without
+// repeats; nodes lists the vertices to look at (closed under adjacency).
+class LowerBound {
+   public:
+    // Deletes a vertex of minimum degree until none are left (Matula and
+    // Beck's bucket order), O(n + m).
+    template <typename G>
+    static int degeneracy(const G &g, const std::vector<int> &nodes) {
+        int size = nodes.size();
+        std::vector<int> deg(g.n, 0), pos(g.n, -1), vert(size);
+        int maxDegree = 0;
+        for (int i = 0; i < size; i++) {
+            deg[nodes[i]] = g.degree(nodes[i]);
+            maxDegree = std::max(maxDegree, deg[nodes[i]]);
+        }
+        // bin[d]: first slot of degree d in vert, which is sorted by degree
+        std::vector<int> bin(maxDegree + 1, 0);
+        for (int i = 0; i < size; i++)
+            bin[deg[nodes[i]]]++;
+        for (int d = 0, start = 0; d <= maxDegree; d++) {
+            int count = bin[d];
+            bin[d] = start;
+            start += count;
+        }
+        for (int i = 0; i < size; i++) {
+            int v = nodes[i];
+            pos[v] = bin[deg[v]]++;
+            vert[pos[v]] = v;
+        }
+        for (int d = maxDegree; d > 0; d--)
+            bin[d] = bin[d - 1];
+        bin[0] = 0;
+
+        int best = 0;
+        for (int i = 0; i < size; i++) {
+            int v = vert[i];
+            best = std::max(best, deg[v]);
+            g.forEachNeighbour(v, [&](int u) {
+                if (deg[u] <= deg[v]) return;
+                // move u to the front of its bucket, then shrink the bucket
+                int du = deg[u], pu = pos[u], pw = bin[du], w = vert[pw];
+                if (u != w) {
+                    pos[u] = pw;
+                    vert[pw] = u;
+                    pos[w] = pu;
+                    vert[pu] = w;
+                }
+                bin[du]++;
+                deg[u]--;
+            });
+        }
+        return best;
+    }
+
+    // MMD+ (minor-min-width): contracts a vertex of minimum degree into one
+    // of its neighbours until one vertex is left. The min-d rule picks the
+    // neighbour of least degree; the least-c rule picks the one with the
+    // fewest common neighbours, which keeps degrees high and is the best
+    // known estimate of the contraction degeneracy.
+    template <typename G>
+    static int minorMinWidth(const G &g, const std::vector<int> &nodes, bool leastCommon) {
+        std::vector<std::vector<int>> adj(g.n);
+        std::set<std::pair<int, int>> queue;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            int v = nodes[i];
+            g.forEachNeighbour(v, [&](int u) { adj[v].push_back(u); });
+            std::sort(adj[v].begin(), adj[v].end());
+            queue.insert(std::make_pair((int)adj[v].size(), v));
+        }
+
+        int best = 0;
+        while (queue.size() > 1) {
+            int d = queue.begin()->first, v = queue.begin()->second;
+            queue.erase(queue.begin());
+            best = std::max(best, d);
+            if (d == 0) continue;
+
+            int into = -1, intoKey = 0;
+            for (size_t i = 0; i < adj[v].size(); i++) {
+                int u = adj[v][i];
+                int key = leastCommon ? common(adj[u], adj[v]) : (int)adj[u].size();
+                if (into < 0 || key < intoKey || (key == intoKey && adj[u].size() < adj[into].size())) {
+                    into = u;
+                    intoKey = key;
+                }
+            }
+
+            queue.erase(std::make_pair((int)adj[into].size(), into));
+            std::vector<int> nb;
+            nb.swap(adj[v]);
+            for (size_t i = 0; i < nb.size(); i++) {
+                int w = nb[i];
+                if (w != into) queue.erase(std::make_pair((int)adj[w].size(), w));
+                eraseSorted(adj[w], v);
+                if (w != into && !std::binary_search(adj[w].begin(), adj[w].end(), into)) {
+                    insertSorted(adj[w], into);
+                    insertSorted(adj[into], w);
+                }
+                if (w != into) queue.insert(std::make_pair((int)adj[w].size(), w));
+            }
+            queue.insert(std::make_pair((int)adj[into].size(), into));
+        }
+        return best;
+    }
+
+    // the best of the bounds above
+    template <typename G>
+    static int best(const G &g, const std::vector<int> &nodes) {
+        int bound = degeneracy(g, nodes);
+        bound = std::max(bound, minorMinWidth(g, nodes, false));
+        return std::max(bound, minorMinWidth(g, nodes, true));
+    }
+
+   private:
+    static int common(const std::vector<int> &a, const std::vector<int> &b) {
+        int count = 0;
+        std::vector<int>::const_iterator x = a.begin(), y = b.begin();
+        while (x != a.end() && y != b.end()) {
+            if (*x < *y) {
+                x++;
+            } else if (*y < *x) {
+                y++;
+            } else {
+                count++;
+                x++;
+                y++;
+            }
+        }
+        return count;
+    }
+
+    static void insertSorted(std::vector<int> &row, int x) {
+        row.insert(std::lower_bound(row.begin(), row.end(), x), x);
+    }
+
+    static void eraseSorted(std::vector<int> &row, int x) {
+        row.erase(std::lower_bound(row.begin(), row.end(), x));
+    }
+};
+
+#endif
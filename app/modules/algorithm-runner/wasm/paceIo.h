@@ -0,0 +1,207 @@
+#ifndef PACE_IO_H
+#define PACE_IO_H
+
+#include <stdio.h>
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Reader for PACE 2016 .gr files: a "p tw <n> <m>" line, then one "u v" edge
+// per line, with "c" comment lines anywhere. Input is pulled through a fixed
+// buffer and numbers are parsed straight out of it, so no line or token is
+// ever copied into a string. Works on pipes as well as files.
+class PaceReader {
+   public:
+    explicit PaceReader(FILE *in) : buffer(1 << 16) {
+        this->in = in;
+        pos = 0;
+        len = 0;
+        line = 1;
+    }
+
+    // Fills n (from the p line) and edges (vertex ids as written). Returns
+    // false with a message on malformed input.
+    bool read(int &n, std::vector<std::pair<int, int>> &edges, std::string &error) {
+        n = -1;
+        edges.clear();
+        int c;
+        while ((c = skipBlanks()) != EOF) {
+            if (c == '\n') {
+                next();
+                line++;
+            } else if (c == 'c') {
+                skipLine();
+            } else if (c == 'p') {
+                next();
+                if (skipBlanks() != 't' || next() != 't' || next() != 'w') return fail("expected \"p tw\"", error);
+                long long m;
+                if (!readInt(n) || !readInt(m)) return fail("bad p line", error);
+                edges.reserve(m);
+                skipLine();
+            } else {
+                if (n < 0) return fail("edge before the p line", error);
+                int u, v;
+                if (!readInt(u) || !readInt(v)) return fail("bad edge", error);
+                edges.push_back(std::make_pair(u, v));
+                skipLine();
+            }
+        }
+        if (n < 0) return fail("missing p line", error);
+        return true;
+    }
+
+   private:
+    FILE *in;
+    std::vector<char> buffer;
+    size_t pos, len;
+    int line;
+
+    int peek() {
+        if (pos == len) {
+            len = fread(buffer.data(), 1, buffer.size(), in);
+            pos = 0;
+            if (len == 0) return EOF;
+        }
+        return (unsigned char)buffer[pos];
+    }
+
+    int next() {
+        int c = peek();
+        if (c != EOF) pos++;
+        return c;
+    }
+
+    int skipBlanks() {
+        int c;
+        while ((c = peek()) == ' ' || c == '\t' || c == '\r')
+            pos++;
+        return c;
+    }
+
+    void skipLine() {
+        int c;
+        while ((c = next()) != EOF && c != '\n')
+            ;
+        line++;
+    }
+
+    template <typename T>
+    bool readInt(T &x) {
+        int c = skipBlanks();
+        if (c < '0' || c > '9') return false;
+        x = 0;
+        while ((c = peek()) >= '0' && c <= '9') {
+            x = x * 10 + (c - '0');
+            pos++;
+        }
+        return true;
+    }
+
+    bool fail(const char *what, std::string &error) {
+        error = "line " + std::to_string(line) + ": " + what;
+        return false;
+    }
+};
+
+// Buffered writer for PACE .td output: "s td <bags> <width + 1> <n>", one
+// "b <i> <vertices>" line per bag and one "<i> <j>" line per tree edge, bags
+// numbered from 1. Integers are formatted by hand into a fixed buffer that
+// is handed to stdio only when full.
+class PaceWriter {
+   public:
+    explicit PaceWriter(FILE *out) : buffer(1 << 16) {
+        this->out = out;
+        len = 0;
+    }
+
+    ~PaceWriter() {
+        flush();
+    }
+
+    // a "c <text>" comment line, which readers skip
+    void comment(const char *text) {
+        put("c ");
+        put(text);
+        put('\n');
+    }
+
+    // bags hold dense ids, idOf maps them to the ids written
+    void write(const std::vector<std::set<int>> &bags, const std::vector<std::pair<int, int>> &treeEdges,
+               const std::vector<int> &idOf, int numberOfVertices) {
+        int widthPlusOne = 0;
+        for (size_t i = 0; i < bags.size(); i++)
+            if ((int)bags[i].size() > widthPlusOne) widthPlusOne = bags[i].size();
+
+        put("s td ");
+        put(bags.size());
+        put(' ');
+        put(widthPlusOne);
+        put(' ');
+        put(numberOfVertices);
+        put('\n');
+        for (size_t i = 0; i < bags.size(); i++) {
+            put("b ");
+            put(i + 1);
+            for (std::set<int>::const_iterator it = bags[i].begin(); it != bags[i].end(); it++) {
+                put(' ');
+                put(idOf[*it]);
+            }
+            put('\n');
+        }
+        for (size_t i = 0; i < treeEdges.size(); i++) {
+            put(treeEdges[i].first + 1);
+            put(' ');
+            put(treeEdges[i].second + 1);
+            put('\n');
+        }
+    }
+
+    void flush() {
+        if (len) fwrite(buffer.data(), 1, len, out);
+        len = 0;
+        fflush(out);
+    }
+
+   private:
+    FILE *out;
+    std::vector<char> buffer;
+    size_t len;
+
+    void put(char c) {
+        if (len == buffer.size()) flush();
+        buffer[len++] = c;
+    }
+
+    void put(const char *s) {
+        while (*s)
+            put(*s++);
+    }
+
+    void put(long long x) {
+        if (len + 24 > buffer.size()) flush();
+        if (x < 0) {
+            buffer[len++] = '-';
+            x = -x;
+        }
+        char digits[20];
+        int d = 0;
+        do {
+            digits[d++] = '0' + x % 10;
+            x /= 10;
+        } while (x);
+        while (d)
+            buffer[len++] = digits[--d];
+    }
+
+    void put(int x) {
+        put((long long)x);
+    }
+
+    void put(size_t x) {
+        put((long long)x);
+    }
+};
+
+#endif
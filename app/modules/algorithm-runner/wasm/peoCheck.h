@@ -0,0 +1,49 @@
+#ifndef PEO_CHECK_H
+#define PEO_CHECK_H
+
+#include <tuple>
+#include <vector>
+
+// Perfect elimination ordering test of Tarjan and Yannakakis. G needs a dense
+// vertex count `n` and `forEachNeighbour(v, f)`; ordering[0] is eliminated
+// first. Runs in O(n + m) with one position array, one follower array and a
+// single marker array.
+class PeoCheck {
+   public:
+    // Returns true if ordering is a PEO. Otherwise violation holds (x, v, y):
+    // x and y are both later neighbours of v but x and y are not adjacent, so
+    // adding the edge x-y repairs this spot.
+    template <typename G>
+    static bool verify(const G &g, const std::vector<int> &ordering, std::tuple<int, int, int> &violation) {
+        int size = ordering.size();
+        std::vector<int> pos(g.n, -1), follower(g.n, -1), marker(g.n, -1);
+        for (int i = 0; i < size; i++)
+            pos[ordering[i]] = i;
+
+        for (int i = 0; i < size; i++) {
+            int w = ordering[i];
+            follower[w] = w;
+            marker[w] = i;
+            // w is a later neighbour of every earlier neighbour v; the first
+            // such w seen is v's follower (its earliest later neighbour)
+            g.forEachNeighbour(w, [&](int v) {
+                if (pos[v] < 0 || pos[v] >= i) return;
+                marker[v] = i;
+                if (follower[v] == v) follower[v] = w;
+            });
+            // every later neighbour of v must be adjacent to v's follower
+            bool ok = true;
+            g.forEachNeighbour(w, [&](int v) {
+                if (!ok || pos[v] < 0 || pos[v] >= i) return;
+                if (marker[follower[v]] < i) {
+                    violation = std::make_tuple(follower[v], v, w);
+                    ok = false;
+                }
+            });
+            if (!ok) return false;
+        }
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef RESTART_POOL_H
+#define RESTART_POOL_H
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __EMSCRIPTEN_PTHREADS__
+#include <emscripten/threading.h>
+#endif
+
+// Work-stealing pool for independent restarts. Tasks 0..count-1 are dealt
+// round-robin to one deque per worker; a worker takes from the front of its
+// own deque and steals from the back of the others once it runs dry. The
+// calling thread is worker 0.
+//
+// Natively this uses std::thread. Under Emscripten std::thread is backed by
+// pthreads and needs a -pthread build (SharedArrayBuffer); without it the pool
+// runs everything on the calling thread. With it, a thread can only start on
+// a web worker spawned ahead of time, not while its creator blocks in join,
+// so the pool never asks for more than the PTHREAD_POOL_SIZE the build links
+// with (one per logical core).
+class RestartPool {
+   public:
+    explicit RestartPool(int threads) {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+        threads = 1;
+#elif defined(__EMSCRIPTEN_PTHREADS__)
+        int cores = emscripten_num_logical_cores();
+        if (threads <= 0 || threads > cores) threads = cores;
+#else
+        if (threads <= 0) threads = std::thread::hardware_concurrency();
+#endif
+        if (threads <= 0) threads = 1;
+        this->threads = threads;
+    }
+
+    int size() const {
+        return threads;
+    }
+
+    // Runs task(index) for every index in [0, count) and returns when all of
+    // them are done.
+    template <typename F>
+    void run(int count, F task) {
+        int workers = threads < count ? threads : count;
+        if (workers <= 1) {
+            for (int i = 0; i < count; i++)
+                task(i);
+            return;
+        }
+
+        std::vector<Queue> queues(workers);
+        for (int i = 0; i < count; i++)
+            queues[i % workers].tasks.push_back(i);
+
+        std::vector<std::thread> pool;
+        for (int w = 1; w < workers; w++)
+            pool.push_back(std::thread([&, w]() { work(queues, w, task); }));
+        work(queues, 0, task);
+        for (size_t i = 0; i < pool.size(); i++)
+            pool[i].join();
+    }
+
+   private:
+    struct Queue {
+        std::mutex lock;
+        std::deque<int> tasks;
+    };
+
+    int threads;
+
+    template <typename F>
+    static void work(std::vector<Queue> &queues, int self, F &task) {
+        int workers = queues.size();
+        while (true) {
+            int index = -1;
+            {
+                std::lock_guard<std::mutex> guard(queues[self].lock);
+                if (!queues[self].tasks.empty()) {
+                    index = queues[self].tasks.front();
+                    queues[self].tasks.pop_front();
+                }
+            }
+            for (int i = 1; index < 0 && i < workers; i++) {
+                Queue &victim = queues[(self + i) % workers];
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if (!victim.tasks.empty()) {
+                    index = victim.tasks.back();
+                    victim.tasks.pop_back();
+                }
+            }
+            // no task is ever added after run starts, so empty means done
+            if (index < 0) return;
+            task(index);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef RUN_STATS_H
+#define RUN_STATS_H
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// What one restart did. Filled in by Graph::triangulate and bestOfRestarts
+// when the run collects stats; times are wall milliseconds.
+struct RestartStats {
+    int component;  // 1-based, 0 when the graph is connected
+    int atom;       // 1-based atom of the component, 0 when it has no clique separator
+    int index;      // restart index
+    int width;      // -1 when the shared bound or a cancel dropped the restart
+    long long paths;       // chordless paths x-u-y the cycle search started from
+    long long cycles;      // chordless cycles found (broken ones are never found)
+    int killRounds;        // kill_cycles rounds
+    long long chords;      // chords added by kill_cycles (fill edges for the greedy strategies)
+    long long repairs;     // chords added by the isChordal repair loop, one retry each
+    long long arenaBytes;  // cycle search memory taken from the restart arena
+    double cyclesMs;       // kill_cycles: cycle search and chords together
+    double repairMs, triangulateMs, decomposeMs;
+
+    RestartStats(int component = 0, int atom = 0, int index = 0) {
+        this->component = component;
+        this->atom = atom;
+        this->index = index;
+        width = -1;
+        paths = cycles = chords = repairs = arenaBytes = 0;
+        killRounds = 0;
+        cyclesMs = repairMs = triangulateMs = decomposeMs = 0;
+    }
+};
+
+// Everything a run collects when RunOptions::stats is set: wall time per
+// top-level phase (in the order first seen), one entry per restart, the size
+// of the reduced kernel and the heap high-water mark. Restarts may be added
+// from any worker thread.
+class RunStats {
+   public:
+    typedef std::chrono::steady_clock Clock;
+
+    std::vector<std::pair<std::string, double>> phases;
+    std::vector<RestartStats> restarts;
+    // peakHeapBytes() at the end of the run, set by the front end
+    long long peakHeapBytes;
+    // what the reduction rules left for the restarts, -1 when they did not run
+    int kernelVertices, kernelEdges;
+    // lookups of the whole graph and its components in RunOptions::cache
+    int cacheHits, cacheMisses;
+
+    RunStats() {
+        peakHeapBytes = 0;
+        kernelVertices = kernelEdges = -1;
+        cacheHits = cacheMisses = 0;
+    }
+
+    static double msSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void addPhase(const std::string &name, double ms) {
+        for (size_t i = 0; i < phases.size(); i++) {
+            if (phases[i].first == name) {
+                phases[i].second += ms;
+                return;
+            }
+        }
+        phases.push_back(std::make_pair(name, ms));
+    }
+
+    void addRestart(const RestartStats &restart) {
+        std::lock_guard<std::mutex> guard(lock);
+        restarts.push_back(restart);
+    }
+
+    std::string toJson() const {
+        std::string out = "{\"phases\":{";
+        for (size_t i = 0; i < phases.size(); i++) {
+            if (i) out += ",";
+            out += "\"" + phases[i].first + "\":" + number(phases[i].second);
+        }
+        std::vector<RestartStats> sorted = ordered();
+        out += "},\"peakHeapBytes\":" + std::to_string(peakHeapBytes) +
+               ",\"kernelVertices\":" + std::to_string(kernelVertices) +
+               ",\"kernelEdges\":" + std::to_string(kernelEdges) +
+               ",\"cacheHits\":" + std::to_string(cacheHits) +
+               ",\"cacheMisses\":" + std::to_string(cacheMisses) +
+               ",\"restartCount\":" + std::to_string(sorted.size()) + ",\"restarts\":[";
+        for (size_t i = 0; i < sorted.size(); i++) {
+            const RestartStats &r = sorted[i];
+            if (i) out += ",";
+            out += "{\"component\":" + std::to_string(r.component) + ",\"atom\":" + std::to_string(r.atom) +
+                   ",\"index\":" + std::to_string(r.index) +
+                   ",\"width\":" + std::to_string(r.width) + ",\"paths\":" + std::to_string(r.paths) +
+                   ",\"cycles\":" + std::to_string(r.cycles) + ",\"killRounds\":" + std::to_string(r.killRounds) +
+                   ",\"chords\":" + std::to_string(r.chords) + ",\"repairs\":" + std::to_string(r.repairs) +
+                   ",\"arenaBytes\":" + std::to_string(r.arenaBytes) +
+                   ",\"cyclesMs\":" + number(r.cyclesMs) +
+                   ",\"repairMs\":" + number(r.repairMs) + ",\"triangulateMs\":" + number(r.triangulateMs) +
+                   ",\"decomposeMs\":" + number(r.decomposeMs) + "}";
+        }
+        return out + "]}\n";
+    }
+
+    // one row per restart; the phase totals, the heap peak, the kernel size
+    // and the cache counters go in "#"-prefixed lines first
+    std::string toCsv() const {
+        std::string out;
+        for (size_t i = 0; i < phases.size(); i++)
+            out += "# " + phases[i].first + "," + number(phases[i].second) + "\n";
+        out += "# peakHeapBytes," + std::to_string(peakHeapBytes) + "\n";
+        out += "# kernelVertices," + std::to_string(kernelVertices) + "\n";
+        out += "# kernelEdges," + std::to_string(kernelEdges) + "\n";
+        out += "# cacheHits," + std::to_string(cacheHits) + "\n";
+        out += "# cacheMisses," + std::to_string(cacheMisses) + "\n";
+        out += "component,atom,index,width,paths,cycles,killRounds,chords,repairs,arenaBytes,"
+               "cyclesMs,repairMs,triangulateMs,decomposeMs\n";
+        std::vector<RestartStats> sorted = ordered();
+        for (size_t i = 0; i < sorted.size(); i++) {
+            const RestartStats &r = sorted[i];
+            out += std::to_string(r.component) + "," + std::to_string(r.atom) + "," + std::to_string(r.index) + "," +
+                   std::to_string(r.width) + "," +
+                   std::to_string(r.paths) + "," + std::to_string(r.cycles) + "," + std::to_string(r.killRounds) +
+                   "," + std::to_string(r.chords) + "," + std::to_string(r.repairs) + "," +
+                   std::to_string(r.arenaBytes) + "," + number(r.cyclesMs) + "," +
+                   number(r.repairMs) + "," + number(r.triangulateMs) + "," +
+                   number(r.decomposeMs) + "\n";
+        }
+        return out;
+    }
+
+   private:
+    std::mutex lock;
+
+    // workers finish restarts in any order; dumps list them by component,
+    // atom and index so two runs diff cleanly
+    std::vector<RestartStats> ordered() const {
+        std::vector<RestartStats> ret(restarts);
+        std::sort(ret.begin(), ret.end(), [](const RestartStats &a, const RestartStats &b) {
+            if (a.component != b.component) return a.component < b.component;
+            return a.atom != b.atom ? a.atom < b.atom : a.index < b.index;
+        });
+        return ret;
+    }
+
+    static std::string number(double x) {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.4f", x);
+        return buffer;
+    }
+};
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef SEARCH_ORDERING_H
+#define SEARCH_ORDERING_H
+
+#include <vector>
+
+// Graph searches whose reverse visit order is a perfect elimination ordering
+// exactly when the graph is chordal. G needs a dense vertex count `n` and
+// `forEachNeighbour(v, f)`; nodes lists the vertices to search (any subset of
+// 0..n-1 closed under adjacency). Both return vertices in visit order and run
+// in O(n + m).
+class SearchOrdering {
+   public:
+    // LexBFS by partition refinement. The unvisited vertices sit in one array
+    // where every class of equal labels is a contiguous range, highest label
+    // first. Visiting v moves its unvisited neighbours to the front of their
+    // class and splits that front off as a new class just before the old one.
+    template <typename G>
+    static std::vector<int> lexBfs(const G &g, const std::vector<int> &nodes) {
+        int size = nodes.size();
+        std::vector<int> order(nodes), pos(g.n, -1), cls(g.n, -1);
+        std::vector<int> classStart, classEnd, moved;
+        std::vector<int> touched;
+        std::vector<int> visit;
+        visit.reserve(size);
+
+        for (int i = 0; i < size; i++) {
+            pos[order[i]] = i;
+            cls[order[i]] = 0;
+        }
+        classStart.push_back(0);
+        classEnd.push_back(size);
+        moved.push_back(0);
+
+        for (int i = 0; i < size; i++) {
+            int v = order[i];
+            classStart[cls[v]]++;
+            cls[v] = -1;
+            visit.push_back(v);
+
+            g.forEachNeighbour(v, [&](int w) {
+                int c = cls[w];
+                if (c < 0) return;
+                if (moved[c] == 0) touched.push_back(c);
+                // swap w with the first vertex of c not moved yet
+                int p = classStart[c] + moved[c];
+                int u = order[p];
+                order[pos[w]] = u;
+                pos[u] = pos[w];
+                order[p] = w;
+                pos[w] = p;
+                moved[c]++;
+            });
+
+            for (size_t t = 0; t < touched.size(); t++) {
+                int c = touched[t];
+                int split = classStart[c] + moved[c];
+                moved[c] = 0;
+                if (split == classEnd[c]) continue;  // every vertex of c moved, order unchanged
+
+                int nc = classStart.size();
+                classStart.push_back(classStart[c]);
+                classEnd.push_back(split);
+                moved.push_back(0);
+                for (int p = classStart[c]; p < split; p++)
+                    cls[order[p]] = nc;
+                classStart[c] = split;
+            }
+            touched.clear();
+        }
+        return visit;
+    }
+
+    // Maximum cardinality search: always visit an unvisited vertex with the
+    // most visited neighbours. Vertices live in doubly linked buckets by
+    // weight, and the top bucket index only drops by one per visit.
+    template <typename G>
+    static std::vector<int> mcs(const G &g, const std::vector<int> &nodes) {
+        int size = nodes.size();
+        std::vector<int> weight(g.n, -1), prev(g.n, -1), next(g.n, -1);
+        std::vector<int> bucket(size + 1, -1);
+        std::vector<int> visit;
+        visit.reserve(size);
+
+        // insert in reverse so the smallest id is at the head of bucket 0
+        for (int i = size - 1; i >= 0; i--) {
+            int v = nodes[i];
+            weight[v] = 0;
+            push(bucket, prev, next, 0, v);
+        }
+
+        int top = 0;
+        for (int i = 0; i < size; i++) {
+            while (top > 0 && bucket[top] == -1)
+                top--;
+            int v = bucket[top];
+            unlink(bucket, prev, next, top, v);
+            weight[v] = -1;
+            visit.push_back(v);
+
+            g.forEachNeighbour(v, [&](int w) {
+                if (weight[w] < 0) return;
+                unlink(bucket, prev, next, weight[w], w);
+                weight[w]++;
+                push(bucket, prev, next, weight[w], w);
+                if (weight[w] > top) top = weight[w];
+            });
+        }
+        return visit;
+    }
+
+   private:
+    static void push(std::vector<int> &bucket, std::vector<int> &prev, std::vector<int> &next, int b, int v) {
+        prev[v] = -1;
+        next[v] = bucket[b];
+        if (bucket[b] != -1) prev[bucket[b]] = v;
+        bucket[b] = v;
+    }
+
+    static void unlink(std::vector<int> &bucket, std::vector<int> &prev, std::vector<int> &next, int b, int v) {
+        if (prev[v] != -1)
+            next[prev[v]] = next[v];
+        else
+            bucket[b] = next[v];
+        if (next[v] != -1) prev[next[v]] = prev[v];
+    }
+};
+
+#endif
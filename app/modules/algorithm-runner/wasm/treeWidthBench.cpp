@@ -0,0 +1,339 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>  // pair
+#include <vector>
+
+#include "paceIo.h"
+#include "treeWidthCore.h"
+
+// Per-phase benchmark of the engine:
+//
+//   treewidth_bench [--format csv|json] [--repeat N] [--time-limit MS]
+//                   [--filter TEXT] [--samples dataPopulation.ts]
+//
+// Every graph (the sample graphs of the editor plus generated ones of
+// growing size) gets each phase timed --repeat times on a fresh copy, and
+// one line per (graph, phase) is written to stdout: minimum and median wall
+// time, plus the phase's own output size (cycles found, chords added,
+// width...). Phases that can blow up (ChordlessCycles, kill_cycles and whole
+// runs) stop after --time-limit and say so in the "interrupted" column.
+
+#ifndef TREEWIDTH_SAMPLES
+#define TREEWIDTH_SAMPLES "app/data/dataPopulation.ts"
+#endif
+
+struct BenchGraph {
+    std::string name;
+    std::shared_ptr<const CsrGraph> csr;
+};
+
+struct BenchOptions {
+    bool json;
+    int repeat;
+    double timeLimitMs;
+    std::string filter;
+    std::string samples;
+
+    BenchOptions() {
+        json = false;
+        repeat = 5;
+        timeLimitMs = 10000;
+        samples = TREEWIDTH_SAMPLES;
+    }
+};
+
+// one output line
+struct PhaseResult {
+    std::string phase;
+    std::vector<double> ms;
+    long long output;  // phase dependent, see runPhases
+    bool interrupted;
+
+    PhaseResult(const std::string &phase) {
+        this->phase = phase;
+        output = 0;
+        interrupted = false;
+    }
+};
+
+static std::shared_ptr<const CsrGraph> buildGraph(int n, const std::vector<std::pair<int, int>> &edges) {
+    std::vector<int> ids(n);
+    for (int v = 0; v < n; v++)
+        ids[v] = v + 1;
+    return std::make_shared<CsrGraph>(ids, edges);
+}
+
+// The `const Name = \`p tw ...\`` blocks of dataPopulation.ts.
+static std::vector<BenchGraph> sampleGraphs(const std::string &path) {
+    std::vector<BenchGraph> ret;
+    std::ifstream file(path.c_str());
+    if (!file) {
+        fprintf(stderr, "treewidth_bench: no sample graphs at %s\n", path.c_str());
+        return ret;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    std::string source = text.str();
+
+    size_t at = 0;
+    while ((at = source.find("const ", at)) != std::string::npos) {
+        at += 6;
+        size_t nameEnd = at;
+        while (nameEnd < source.size() && (isalnum(source[nameEnd]) || source[nameEnd] == '_'))
+            nameEnd++;
+        if (source.compare(nameEnd, 4, " = `") != 0) continue;
+        size_t open = nameEnd + 4;
+        size_t close = source.find('`', open);
+        if (close == std::string::npos) break;
+        std::string name = source.substr(at, nameEnd - at);
+        std::string body = source.substr(open, close - open);
+        at = close + 1;
+        if (body.find("p tw") == std::string::npos) continue;
+
+        FILE *in = fmemopen((void *)body.data(), body.size(), "r");
+        int n;
+        std::vector<std::pair<int, int>> edges;
+        std::string error;
+        bool ok = PaceReader(in).read(n, edges, error);
+        fclose(in);
+        if (!ok) {
+            fprintf(stderr, "treewidth_bench: %s: %s\n", name.c_str(), error.c_str());
+            continue;
+        }
+        for (size_t i = 0; i < edges.size(); i++) {
+            edges[i].first--;
+            edges[i].second--;
+        }
+        BenchGraph g = {name, buildGraph(n, edges)};
+        ret.push_back(g);
+    }
+    return ret;
+}
+
+static BenchGraph cycle(int n) {
+    std::vector<std::pair<int, int>> edges;
+    for (int v = 0; v < n; v++)
+        edges.push_back(std::make_pair(v, (v + 1) % n));
+    BenchGraph g = {"cycle_" + std::to_string(n), buildGraph(n, edges)};
+    return g;
+}
+
+static BenchGraph grid(int side) {
+    std::vector<std::pair<int, int>> edges;
+    for (int r = 0; r < side; r++) {
+        for (int c = 0; c < side; c++) {
+            int v = r * side + c;
+            if (c + 1 < side) edges.push_back(std::make_pair(v, v + 1));
+            if (r + 1 < side) edges.push_back(std::make_pair(v, v + side));
+        }
+    }
+    BenchGraph g = {"grid_" + std::to_string(side) + "x" + std::to_string(side), buildGraph(side * side, edges)};
+    return g;
+}
+
+// G(n, m) with a fixed seed, so every run benchmarks the same graph
+static BenchGraph randomGraph(int n, int m) {
+    std::mt19937 rng(n * 7919 + m);
+    std::set<std::pair<int, int>> edges;
+    while ((int)edges.size() < m) {
+        int u = rng() % n, v = rng() % n;
+        if (u == v) continue;
+        edges.insert(std::make_pair(std::min(u, v), std::max(u, v)));
+    }
+    BenchGraph g = {"random_" + std::to_string(n) + "_" + std::to_string(m),
+                    buildGraph(n, std::vector<std::pair<int, int>>(edges.begin(), edges.end()))};
+    return g;
+}
+
+static std::vector<BenchGraph> syntheticGraphs() {
+    std::vector<BenchGraph> ret;
+    for (int n = 64; n <= 4096; n *= 4)
+        ret.push_back(cycle(n));
+    for (int side = 4; side <= 16; side *= 2)
+        ret.push_back(grid(side));
+    for (int n = 32; n <= 512; n *= 2)
+        ret.push_back(randomGraph(n, n * 3 / 2));
+    return ret;
+}
+
+typedef std::chrono::steady_clock Clock;
+
+static double since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Times every phase of one graph. Each repetition starts from a fresh Graph
+// seeded like restart 0 of a default run, so kill_cycles adds the same
+// chords every time.
+static std::vector<PhaseResult> runPhases(const BenchGraph &bg, const BenchOptions &options) {
+    PhaseResult dfs("DFS"), lexBfs("lex_bfs"), chordal("isChordal"), cycles("ChordlessCycles"),
+        kill("kill_cycles"), decomposition("computeTreeDecomposition"), whole("runTreeWidth");
+
+    for (int r = 0; r < options.repeat; r++) {
+        // output: components
+        {
+            Graph g(bg.csr);
+            Clock::time_point start = Clock::now();
+            g.DFS();
+            dfs.ms.push_back(since(start));
+            dfs.output = g.no_of_components;
+        }
+        // output: ordering length
+        {
+            Graph g(bg.csr);
+            Clock::time_point start = Clock::now();
+            std::vector<int> ordering = g.lex_bfs();
+            lexBfs.ms.push_back(since(start));
+            lexBfs.output = ordering.size();
+        }
+        // output: 1 if the input is already chordal
+        {
+            Graph g(bg.csr);
+            Clock::time_point start = Clock::now();
+            chordal.output = g.isChordal().first;
+            chordal.ms.push_back(since(start));
+        }
+
+        // output: chordless cycles of the input, counted without chords
+        {
+            CancelToken token;
+            token.setTimeLimit(options.timeLimitMs);
+            Graph g(bg.csr);
+            g.interrupted = CancelCheck(&token);
+            Clock::time_point start = Clock::now();
+            cycles.output = g.ChordlessCycles();
+            cycles.ms.push_back(since(start));
+            cycles.interrupted = cycles.interrupted || token.cancelled();
+        }
+
+        // output: chords added by one streaming round, then width
+        CancelToken token;
+        token.setTimeLimit(options.timeLimitMs);
+        Graph g(bg.csr);
+        g.reseed(1, 0);
+        g.interrupted = CancelCheck(&token);
+        int before = g.fill.size();
+        Clock::time_point start = Clock::now();
+        g.kill_cycles();
+        kill.ms.push_back(since(start));
+        kill.output = g.fill.size() - before;
+        kill.interrupted = kill.interrupted || token.cancelled();
+
+        // finish the triangulation untimed, then build the bags; this
+        // repetition has no bags if that also runs past the time limit
+        CancelToken repair;
+        repair.setTimeLimit(options.timeLimitMs);
+        g.interrupted = CancelCheck(&repair);
+        std::pair<bool, std::vector<int>> op = g.isChordal();
+        while (!op.first && !g.interrupted()) {
+            g.fill.add(std::get<0>(g.violation), std::get<2>(g.violation));
+            op = g.isChordal();
+        }
+        if (!op.first) {
+            decomposition.interrupted = true;
+            continue;
+        }
+        Tree tree(bg.csr->n);
+        start = Clock::now();
+        tree.computeTreeDecomposition(op.second, g);
+        decomposition.ms.push_back(since(start));
+        decomposition.output = tree.getTreeWidthPlusOne() - 1;
+    }
+
+    // output: width; whole runs are long, so they are repeated at most twice
+    for (int r = 0; r < std::min(options.repeat, 2); r++) {
+        CancelToken token;
+        token.setTimeLimit(options.timeLimitMs);
+        RunOptions run;
+        run.cancel = &token;
+        Clock::time_point start = Clock::now();
+        Tree *tree = decompose(bg.csr, run);
+        whole.ms.push_back(since(start));
+        whole.output = tree->getTreeWidthPlusOne() - 1;
+        whole.interrupted = whole.interrupted || token.cancelled();
+        delete tree;
+    }
+
+    std::vector<PhaseResult> ret;
+    ret.push_back(dfs);
+    ret.push_back(lexBfs);
+    ret.push_back(chordal);
+    ret.push_back(cycles);
+    ret.push_back(kill);
+    ret.push_back(decomposition);
+    ret.push_back(whole);
+    return ret;
+}
+
+static void print(const BenchGraph &bg, PhaseResult &result, bool json) {
+    if (result.ms.empty()) result.ms.push_back(0);
+    std::sort(result.ms.begin(), result.ms.end());
+    double min = result.ms.front();
+    double median = result.ms[result.ms.size() / 2];
+    if (json) {
+        printf("{\"graph\":\"%s\",\"n\":%d,\"m\":%d,\"phase\":\"%s\",\"repeat\":%d,"
+               "\"min_ms\":%.4f,\"median_ms\":%.4f,\"output\":%lld,\"interrupted\":%s}\n",
+               bg.name.c_str(), bg.csr->n, bg.csr->edgeCount(), result.phase.c_str(), (int)result.ms.size(),
+               min, median, result.output, result.interrupted ? "true" : "false");
+    } else {
+        printf("%s,%d,%d,%s,%d,%.4f,%.4f,%lld,%d\n", bg.name.c_str(), bg.csr->n, bg.csr->edgeCount(),
+               result.phase.c_str(), (int)result.ms.size(), min, median, result.output, (int)result.interrupted);
+    }
+    fflush(stdout);
+}
+
+// to stdout for --help, to stderr with exit status 2 for bad arguments
+static void usage(FILE *out) {
+    fprintf(out,
+            "usage: treewidth_bench [--format csv|json] [--repeat N] [--time-limit MS]\n"
+            "                       [--filter TEXT] [--samples dataPopulation.ts]\n");
+}
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--format" && hasValue) {
+            options.json = strcmp(argv[++i], "json") == 0;
+        } else if (arg == "--repeat" && hasValue) {
+            options.repeat = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--time-limit" && hasValue) {
+            options.timeLimitMs = atof(argv[++i]);
+        } else if (arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (arg == "--samples" && hasValue) {
+            options.samples = argv[++i];
+        } else if (arg == "-h" || arg == "--help") {
+            usage(stdout);
+            return 0;
+        } else {
+            usage(stderr);
+            return 2;
+        }
+    }
+
+    std::vector<BenchGraph> graphs = sampleGraphs(options.samples);
+    std::vector<BenchGraph> synthetic = syntheticGraphs();
+    graphs.insert(graphs.end(), synthetic.begin(), synthetic.end());
+
+    if (!options.json) printf("graph,n,m,phase,repeat,min_ms,median_ms,output,interrupted\n");
+    for (size_t i = 0; i < graphs.size(); i++) {
+        if (graphs[i].name.find(options.filter) == std::string::npos) continue;
+        std::vector<PhaseResult> results = runPhases(graphs[i], options);
+        for (size_t j = 0; j < results.size(); j++)
+            print(graphs[i], results[j], options.json);
+    }
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>  // pair
+#include <vector>
+
+#include "paceIo.h"
+#include "treeWidthCore.h"
+
+// Native front end of the same engine the web worker runs:
+//
+//   treewidth [options] [input.gr]
+//
+// reads a PACE .gr file (stdin without an argument) and writes the tree
+// decomposition as .td to stdout, with the treewidth lower bound the run
+// proved in a leading comment line. SIGINT and SIGTERM stop the run early and
+// still print the best decomposition found so far, as PACE expects.
+
+static CancelToken *runToken = nullptr;
+
+static void handleSignal(int signalNum) {
+    if ((signalNum == SIGINT || signalNum == SIGTERM) && runToken) runToken->cancel();
+}
+
+// to stdout for --help, to stderr with exit status 2 for bad arguments
+static void usage(FILE *out) {
+    fprintf(out,
+            "usage: treewidth [options] [input.gr]\n"
+            "  -s, --strategy NAME   chordless-cycles (default), min-degree, min-fill, min-width\n"
+            "      --seed N          restart seed (default 1)\n"
+            "  -j, --threads N       restart workers, 0 = one per hardware thread (default)\n"
+            "  -t, --time-limit MS   stop after MS milliseconds with the best result so far\n"
+            "      --max-cycles N    chordless cycles each restart breaks, 0 = all (default)\n"
+            "      --no-reduce       skip the safe reduction rules and run on the whole graph\n"
+            "      --no-atoms        solve components whole instead of split along clique separators\n"
+            "      --exact-max N     solve components of at most N vertices exactly, 0 = never\n"
+            "                        (default 64, the most there can be)\n"
+            "      --exact-time MS   time all exact solves may take together, 0 = no cap (default 1000)\n"
+            "      --exact-memory MB memory one exact solve may use (default 64)\n"
+            "      --local-search MS anneal each component's elimination ordering for MS milliseconds\n"
+            "                        after its restarts (default 0, none)\n"
+            "      --cache DIR       reuse the best trees earlier runs left in DIR (whole graph and\n"
+            "                        components) and leave this run's there\n"
+            "      --refine          keep improving cached trees instead of returning them as is\n"
+            "  -o, --output FILE     write the .td here instead of stdout\n"
+            "      --stats FILE      write phase times, per-restart counters and peak heap, JSON if\n"
+            "                        FILE ends in .json, CSV otherwise\n");
+}
+
+static bool parseStrategy(const char *name, EliminationStrategy &strategy) {
+    static const char *names[] = {"chordless-cycles", "min-degree", "min-fill", "min-width"};
+    for (int i = 0; i < 4; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            strategy = (EliminationStrategy)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char **argv) {
+    RunOptions options;
+    const char *inputPath = nullptr;
+    const char *outputPath = nullptr;
+    const char *statsPath = nullptr;
+    const char *cachePath = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if ((arg == "-s" || arg == "--strategy") && hasValue) {
+            if (!parseStrategy(argv[++i], options.strategy)) {
+                fprintf(stderr, "treewidth: unknown strategy %s\n", argv[i]);
+                return 2;
+            }
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = strtoul(argv[++i], nullptr, 10);
+        } else if ((arg == "-j" || arg == "--threads") && hasValue) {
+            options.threads = atoi(argv[++i]);
+        } else if ((arg == "-t" || arg == "--time-limit") && hasValue) {
+            options.timeLimitMs = atof(argv[++i]);
+        } else if (arg == "--max-cycles" && hasValue) {
+            options.maxCycles = atoll(argv[++i]);
+        } else if (arg == "--no-reduce") {
+            options.reduce = false;
+        } else if (arg == "--no-atoms") {
+            options.atoms = false;
+        } else if (arg == "--exact-max" && hasValue) {
+            options.exactMaxVertices = atoi(argv[++i]);
+        } else if (arg == "--exact-time" && hasValue) {
+            options.exactTimeLimitMs = atof(argv[++i]);
+        } else if (arg == "--exact-memory" && hasValue) {
+            options.exactMemoryBytes = atoll(argv[++i]) << 20;
+        } else if (arg == "--local-search" && hasValue) {
+            options.localSearchMs = atof(argv[++i]);
+        } else if (arg == "--cache" && hasValue) {
+            cachePath = argv[++i];
+        } else if (arg == "--refine") {
+            options.refineCached = true;
+        } else if ((arg == "-o" || arg == "--output") && hasValue) {
+            outputPath = argv[++i];
+        } else if (arg == "--stats" && hasValue) {
+            statsPath = argv[++i];
+        } else if (arg == "-h" || arg == "--help") {
+            usage(stdout);
+            return 0;
+        } else if (arg[0] != '-' && !inputPath) {
+            inputPath = argv[i];
+        } else {
+            usage(stderr);
+            return 2;
+        }
+    }
+
+    RunStats stats;
+    if (statsPath) options.stats = &stats;
+    std::unique_ptr<FileCacheBackend> cacheFiles;
+    DecompositionCache cache;
+    if (cachePath) {
+        cacheFiles.reset(new FileCacheBackend(cachePath));
+        cache.setBackend(cacheFiles.get());
+        options.cache = &cache;
+    }
+    RunStats::Clock::time_point start = RunStats::Clock::now();
+
+    FILE *in = inputPath ? fopen(inputPath, "rb") : stdin;
+    if (!in) {
+        fprintf(stderr, "treewidth: cannot open %s\n", inputPath);
+        return 1;
+    }
+    int n;
+    std::vector<std::pair<int, int>> edges;
+    std::string error;
+    bool ok = PaceReader(in).read(n, edges, error);
+    if (in != stdin) fclose(in);
+    if (!ok) {
+        fprintf(stderr, "treewidth: %s: %s\n", inputPath ? inputPath : "stdin", error.c_str());
+        return 1;
+    }
+
+    // PACE numbers vertices 1..n; ids outside that range (files saved by the
+    // editor) become vertices of their own
+    std::vector<int> ids(n);
+    for (int v = 0; v < n; v++)
+        ids[v] = v + 1;
+    for (size_t i = 0; i < edges.size(); i++) {
+        if (edges[i].first < 1 || edges[i].first > n) ids.push_back(edges[i].first);
+        if (edges[i].second < 1 || edges[i].second > n) ids.push_back(edges[i].second);
+    }
+    if ((int)ids.size() > n) {
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+    for (size_t i = 0; i < edges.size(); i++) {
+        edges[i].first = CsrGraph::indexIn(ids, edges[i].first);
+        edges[i].second = CsrGraph::indexIn(ids, edges[i].second);
+    }
+    std::shared_ptr<const CsrGraph> csr = std::make_shared<CsrGraph>(ids, edges);
+    std::vector<std::pair<int, int>>().swap(edges);
+    stats.addPhase("read", RunStats::msSince(start));
+
+    CancelToken token;
+    if (options.timeLimitMs > 0) token.setTimeLimit(options.timeLimitMs);
+    options.cancel = &token;
+    runToken = &token;
+    signal(SIGINT, handleSignal);
+    signal(SIGTERM, handleSignal);
+
+    Tree *tree = decompose(csr, options);
+
+    start = RunStats::Clock::now();
+    FILE *out = outputPath ? fopen(outputPath, "wb") : stdout;
+    if (!out) {
+        fprintf(stderr, "treewidth: cannot write %s\n", outputPath);
+        return 1;
+    }
+    {
+        PaceWriter writer(out);
+        std::string bound = "lower bound " + std::to_string(tree->lowerBound);
+        writer.comment(bound.c_str());
+        writer.write(tree->bag, tree->treeEdge, csr->idOf, csr->n);
+    }
+    if (out != stdout) fclose(out);
+    delete tree;
+    stats.addPhase("write", RunStats::msSince(start));
+
+    if (statsPath) {
+        size_t len = strlen(statsPath);
+        bool json = len >= 5 && strcmp(statsPath + len - 5, ".json") == 0;
+        stats.peakHeapBytes = peakHeapBytes();
+        std::string dump = json ? stats.toJson() : stats.toCsv();
+        FILE *file = fopen(statsPath, "wb");
+        if (!file) {
+            fprintf(stderr, "treewidth: cannot write %s\n", statsPath);
+            return 1;
+        }
+        fwrite(dump.data(), 1, dump.size(), file);
+        fclose(file);
+    }
+    return 0;
+}
@@ -0,0 +1,1314 @@
+#ifndef TREE_WIDTH_CORE_H
+#define TREE_WIDTH_CORE_H
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>  // pair
+#include <vector>
+
+#include "arena.h"
+#include "atoms.h"
+#include "cancelToken.h"
+#include "chordlessCycles.h"
+#include "csrGraph.h"
+#include "decompositionCache.h"
+#include "eliminationOrdering.h"
+#include "exactTreewidth.h"
+#include "graphReduction.h"
+#include "localSearch.h"
+#include "lowerBounds.h"
+#include "peoCheck.h"
+#include "restartPool.h"
+#include "runStats.h"
+#include "searchOrdering.h"
+
+#ifndef DEBUG
+#define DEBUG 0
+#endif
+
+// The decomposition engine, shared by the Emscripten bindings in
+// treeWidthAlgo.cpp and the native command line in treeWidthCli.cpp.
+
+class Graph {
+   public:
+    unsigned int n;
+    unsigned int m;
+
+    // connected components from DFS: the members of each, in increasing
+    // order, and the index of every vertex's (-1 outside nodes)
+    std::vector<std::vector<int>> components;
+    std::vector<int> componentOf;
+    // input edges, shared by every copy of the graph
+    std::shared_ptr<const CsrGraph> base;
+    // chords added by kill_cycles
+    FillEdges fill;
+    // vertices of this graph in increasing order (dense ids)
+    std::vector<int> nodes;
+    bool cycle_found;
+    // (x, v, y) from the last failed isChordal: x-v-y with x, y not adjacent
+    std::tuple<int, int, int> violation;
+
+    // labelling
+    std::vector<int> labels;
+    int no_of_components;
+    // cycles kill_cycles looks at per round, 0 = all of them
+    long long maxCycles;
+    // scratch memory of the cycle search, null = the heap
+    Arena *arena;
+    // random source of kill_cycles, see reseed
+    std::mt19937 rng;
+    // stop check of the run this graph belongs to, never fires by default
+    CancelCheck interrupted;
+    // counters of the restart running on this graph, null = not collected
+    RestartStats *stats;
+
+    Graph() {
+        n = 0;
+        m = 0;
+        maxCycles = 0;
+        arena = nullptr;
+        stats = nullptr;
+    }
+    Graph(std::shared_ptr<const CsrGraph> base) {
+        std::vector<int> all(base->n);
+        for (int v = 0; v < base->n; v++)
+            all[v] = v;
+        init(base, all);
+    }
+    Graph(std::shared_ptr<const CsrGraph> base, std::vector<int> nodes) {
+        init(base, nodes);
+    }
+    void init(std::shared_ptr<const CsrGraph> base, std::vector<int> &nodes) {
+        this->base = base;
+        this->n = base->n;
+        this->m = base->edgeCount();
+        this->nodes.swap(nodes);
+        labels.assign(n, 0);
+        fill.reset(n);
+        cycle_found = false;
+        no_of_components = 0;
+        maxCycles = 0;
+        arena = nullptr;
+        stats = nullptr;
+    }
+
+    // Restarts draw from their own generator so they can run on any thread
+    // and still give the same result for the same (seed, restart).
+    void reseed(unsigned int seed, int restart) {
+        std::seed_seq seq{seed, (unsigned int)restart};
+        rng.seed(seq);
+    }
+
+    template <typename F>
+    void forEachNeighbour(int v, F visit) const {
+        for (const int *it = base->begin(v), *end = base->end(v); it != end; it++)
+            visit(*it);
+        for (int a = fill.head[v]; a != -1; a = fill.next[a])
+            visit(fill.to[a]);
+    }
+    std::vector<int> neighbours(int v) const {
+        std::vector<int> ret;
+        ret.reserve(degree(v));
+        forEachNeighbour(v, [&](int u) { ret.push_back(u); });
+        return ret;
+    }
+    int degree(int v) const {
+        return base->degree(v) + fill.degree[v];
+    }
+    bool isAdjacent(int u, int v) const {
+        return base->hasEdge(u, v) || fill.contains(u, v);
+    }
+
+    void printAdjList() {
+        for (unsigned int i = 0; i < n; i++) {
+            std::cout << base->idOf[i] << "\t#";
+            forEachNeighbour(i, [&](int u) { std::cout << " " << base->idOf[u]; });
+            std::cout << std::endl;
+        }
+    }
+
+    // Finds the connected components and whether there is a cycle, in
+    // O(|nodes| + edges). An explicit stack rather than recursion, so long
+    // paths do not run out of (wasm) stack. A graph is a forest exactly when
+    // each component has one edge fewer than vertices.
+    void DFS() {
+        componentOf.assign(n, -1);
+        components.clear();
+        std::vector<int> stack;
+        long long edgeEnds = 0;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            int root = nodes[i];
+            if (componentOf[root] != -1) continue;
+            int c = components.size();
+            components.push_back(std::vector<int>());
+            componentOf[root] = c;
+            stack.push_back(root);
+            while (!stack.empty()) {
+                int v = stack.back();
+                stack.pop_back();
+                forEachNeighbour(v, [&](int u) {
+                    edgeEnds++;
+                    if (componentOf[u] != -1) return;
+                    componentOf[u] = c;
+                    stack.push_back(u);
+                });
+            }
+        }
+        // members by one pass over nodes, which keeps them sorted
+        for (size_t i = 0; i < nodes.size(); i++)
+            components[componentOf[nodes[i]]].push_back(nodes[i]);
+        no_of_components = components.size();
+        cycle_found = edgeEnds / 2 > (long long)nodes.size() - no_of_components;
+    }
+
+    // LexBFS numbering: ordering[0] is the vertex numbered 1, i.e. the last
+    // one visited, so the result is an elimination ordering.
+    std::vector<int> lex_bfs() {
+        std::vector<int> ordering = SearchOrdering::lexBfs(*this, nodes);
+        std::reverse(ordering.begin(), ordering.end());
+        return ordering;
+    }
+
+    // same contract as lex_bfs, using maximum cardinality search
+    std::vector<int> mcs() {
+        std::vector<int> ordering = SearchOrdering::mcs(*this, nodes);
+        std::reverse(ordering.begin(), ordering.end());
+        return ordering;
+    }
+
+    std::pair<bool, std::vector<int>> isChordal() {
+        std::vector<int> vec = lex_bfs();
+        if (DEBUG) {
+            for (unsigned int k = 0; k < vec.size(); k++)
+                std::cout << vec.at(k) << "\n";
+        }
+        bool chordal = PeoCheck::verify(*this, vec, violation);
+        if (DEBUG && chordal) std::cout << "Graph is now Chordal\n";
+        return std::make_pair(chordal, vec);
+    }
+
+    // Make the graph chordal and return a PEO of it. CHORDLESS_CYCLES runs one
+    // round of kill_cycles, then repairs the spots isChordal reports until the
+    // graph is chordal; the greedy strategies add the fill
+    // edges of their elimination ordering. Returns an empty ordering when
+    // interrupted before it is done.
+    std::vector<int> triangulate(EliminationStrategy strategy = CHORDLESS_CYCLES) {
+        if (strategy != CHORDLESS_CYCLES) {
+            EliminationOrdering elimination(*this, nodes);
+            if (!elimination.run(strategy, &interrupted)) return std::vector<int>();
+            for (size_t i = 0; i < elimination.fillEdges.size(); i++)
+                fill.add(elimination.fillEdges[i].first, elimination.fillEdges[i].second);
+            if (stats) stats->chords += elimination.fillEdges.size();
+            return elimination.ordering;
+        }
+        RunStats::Clock::time_point phase;
+        if (stats) phase = RunStats::Clock::now();
+        int chords = fill.size();
+        kill_cycles();
+        if (stats) {
+            stats->killRounds++;
+            stats->chords += fill.size() - chords;
+            stats->cyclesMs += RunStats::msSince(phase);
+            phase = RunStats::Clock::now();
+        }
+        if (interrupted()) return std::vector<int>();
+        std::pair<bool, std::vector<int>> op = isChordal();
+        while (!op.first) {
+            if (interrupted()) return std::vector<int>();
+            fill.add(std::get<0>(violation), std::get<2>(violation));
+            if (stats) stats->repairs++;
+            op = isChordal();
+        }
+        if (stats) stats->repairMs += RunStats::msSince(phase);
+        return op.second;
+    }
+
+    // Labels 1..|nodes| in minimum degree order: each vertex is numbered
+    // once it has the fewest neighbours not numbered yet. The degrees sit in
+    // a BucketQueue, so a round costs O(|nodes| + edges) however often
+    // kill_cycles asks for it.
+    void degreeLabelling() {
+        BucketQueue queue(n, n);
+        for (int i = nodes.size() - 1; i >= 0; i--)
+            queue.insert(nodes[i], degree(nodes[i]));
+        std::vector<int> left(n, 0);
+        for (size_t i = 0; i < nodes.size(); i++)
+            left[nodes[i]] = degree(nodes[i]);
+
+        int v, label = 0;
+        while ((v = queue.popMin()) != -1) {
+            labels[v] = ++label;
+            forEachNeighbour(v, [&](int u) {
+                if (queue.contains(u)) queue.update(u, --left[u]);
+            });
+        }
+    }
+    // Number of chordless cycles, at most maxCycles when that is set. Nothing
+    // is kept: the cycles are only counted as they stream by.
+    long long ChordlessCycles() {
+        degreeLabelling();
+        ChordlessCycleStream cycles(*this, nodes, labels, maxCycles, &interrupted, arena);
+        while (cycles.next())
+            ;
+        if (stats) {
+            stats->paths += cycles.pathCount();
+            stats->cycles += cycles.cycleCount();
+        }
+        return cycles.cycleCount();
+    }
+
+    // One round of cycle killing: chordless cycles stream in one at a time
+    // and each one gets |cycle| - 3 random chords zig-zagging across it
+    // straight away. Cycles an earlier chord already broke never show up,
+    // so work and memory no longer grow with the number of cycles.
+    void kill_cycles() {
+        degreeLabelling();
+        ChordlessCycleStream cycles(*this, nodes, labels, maxCycles, &interrupted, arena);
+        while (cycles.next()) {
+            const ChordlessCycleStream::IntVector &cycle = cycles.cycle();
+            int size = cycle.size();
+
+            int no_of_chords = size - 3;
+            int num1 = rng() % size;
+            int v1 = cycle[num1];
+
+            while (no_of_chords--) {
+                int num2 = rng() % (size - 3);
+                int v2 = cycle[(num1 + 2 + num2) % size];
+
+                if (!isAdjacent(v1, v2)) {
+                    fill.add(v1, v2);
+                    cycles.addChord(v1, v2);
+                }
+                v1 = v2;
+                num1 = (num1 + 2 + num2) % size;
+            }
+        }
+        if (stats) {
+            stats->paths += cycles.pathCount();
+            stats->cycles += cycles.cycleCount();
+        }
+    }
+    // Subgraph induced by k (sorted dense ids) over compact ids 0..|k|-1;
+    // its base->idOf is k, which maps them back (see Tree::relabel). Costs
+    // O((|k| + edges at k) log |k|) and nothing per vertex of this graph, so
+    // components and atoms can each be cut out in turn. Safe to call from
+    // several threads at once.
+    Graph return_GK(const std::vector<int> &k) const {
+        std::vector<std::pair<int, int>> edges;
+        for (size_t i = 0; i < k.size(); i++) {
+            int v = k[i];
+            forEachNeighbour(v, [&](int u) {
+                if (u <= v) return;
+                int j = CsrGraph::indexIn(k, u);
+                if (j >= 0) edges.push_back(std::make_pair((int)i, j));
+            });
+        }
+        return Graph(std::make_shared<CsrGraph>(k, edges));
+    }
+};
+
+class Tree {
+   public:
+    Tree() {
+        numberOfBags = 0;
+        treewidth = 0;
+        lowerBound = 0;
+    }
+
+    Tree(int n) {
+        numberOfBags = 0;
+        treewidth = 0;
+        lowerBound = 0;
+        numberOfVertices = n;
+    }
+
+    int numberOfBags;
+    int treewidth;
+    // no decomposition of the graph is narrower; set by decompose
+    int lowerBound;
+    std::vector<std::set<int>> bag;
+    std::vector<std::pair<int, int>> treeEdge;
+    int numberOfVertices;
+
+    int getNumberOfBags() {
+        return numberOfBags;
+    }
+
+    std::vector<std::set<int>> getBags() {
+        return bag;
+    }
+
+    std::vector<std::pair<int, int>> getTreeEdges() {
+        return treeEdge;
+    }
+
+    // Builds the bags along the PEO v of the chordal graph g, walking it
+    // backwards. Each vertex u keeps the bag it went into (bagOf) and the
+    // higher neighbours of vertex v[i] are those with a larger position. With
+    // p the lowest of them, that set is a subset of p's bag (v is a PEO), so
+    // it equals an existing bag only if it fills all of p's bag: then v[i]
+    // joins that bag, otherwise it gets a new bag hung below p's. Runs in
+    // O(n + sum of bag sizes).
+    //
+    // Gives up and returns false as soon as a bag would hold more than
+    // widthBound vertices (widthBound is in getTreeWidthPlusOne units).
+    bool computeTreeDecomposition(const std::vector<int> &v, const Graph &g,
+                                  int widthBound = std::numeric_limits<int>::max()) {
+        int size = v.size();
+        std::vector<int> position(g.n, -1);
+        for (int i = 0; i < size; i++)
+            position[v[i]] = i;
+        std::vector<int> bagOf(g.n, -1);
+        // stamp of the last vertex that saw u as a higher neighbour, against
+        // neighbours listed twice
+        std::vector<int> seen(g.n, -1);
+        std::vector<std::vector<int>> members;
+        std::vector<int> higher;
+
+        for (int i = size - 1; i >= 0; i--) {
+            int vertex = v[i];
+            higher.clear();
+            int parent = -1;
+            g.forEachNeighbour(vertex, [&](int u) {
+                if (position[u] <= i || seen[u] == i) return;
+                seen[u] = i;
+                higher.push_back(u);
+                if (parent < 0 || position[u] < position[parent]) parent = u;
+            });
+            // either way the bag that receives vertex ends up as higher + vertex
+            if ((int)higher.size() + 1 > widthBound) return false;
+
+            if (parent >= 0 && members[bagOf[parent]].size() == higher.size()) {
+                bagOf[vertex] = bagOf[parent];
+                members[bagOf[vertex]].push_back(vertex);
+                continue;
+            }
+            // the first bag has no parent; a vertex with no higher
+            // neighbours starts a new bag under bag 0
+            if (numberOfBags > 0) treeEdge.push_back(std::make_pair(parent >= 0 ? bagOf[parent] : 0, numberOfBags));
+            bagOf[vertex] = numberOfBags;
+            higher.push_back(vertex);
+            members.push_back(higher);
+            numberOfBags++;
+        }
+
+        for (size_t i = 0; i < members.size(); i++)
+            bag.push_back(std::set<int>(members[i].begin(), members[i].end()));
+        return true;
+    }
+
+    int getTreeWidthPlusOne() const {
+        // if(treewidth != 0)
+        //	return treewidth;
+
+        int retVal = std::numeric_limits<int>::min();
+        std::vector<std::set<int>>::const_iterator it, end;
+        for (it = bag.begin(), end = bag.end(); it != end; it++) {
+            int val = (*it).size();
+            retVal = std::max(retVal, val);
+        }
+        return retVal;
+    }
+
+    // Joins smallTrees, the trees of the components, under an empty bag.
+    // idOf[i], when given, maps the ids of smallTrees[i] to this tree's (the
+    // compact ids of Graph::return_GK).
+    void computeBigTree(std::vector<Tree *> smallTrees,
+                        const std::vector<const std::vector<int> *> &idOf = std::vector<const std::vector<int> *>()) {
+        std::vector<Tree *>::iterator it, end;
+
+        // dummy bag to connect all the trees
+        std::set<int> emptySet;
+        bag.push_back(emptySet);
+        numberOfBags = 1;
+
+        for (it = smallTrees.begin(), end = smallTrees.end(); it != end; it++) {
+            Tree *tree = *it;
+            int treesize = tree->getNumberOfBags();
+            std::vector<std::pair<int, int>> edges = tree->getTreeEdges();
+            std::vector<std::pair<int, int>>::iterator vec_it = edges.begin(), vec_end = edges.end();
+
+            treeEdge.push_back(std::make_pair(0, numberOfBags));
+            for (; vec_it != vec_end; vec_it++) {
+                std::pair<int, int> v = *vec_it;
+                treeEdge.push_back(std::make_pair(v.first + numberOfBags, v.second + numberOfBags));
+            }
+
+            numberOfBags += treesize;
+            size_t first = bag.size();
+            bag.insert(bag.end(), tree->bag.begin(), tree->bag.end());
+            if (!idOf.empty()) renameBags(first, *idOf[it - smallTrees.begin()]);
+        }
+    }
+
+    // Renames every member x of every bag to idOf[x], e.g. from the compact
+    // ids of a Graph::return_GK graph back to those of the graph it came
+    // from. idOf must be increasing.
+    void relabel(const std::vector<int> &idOf) {
+        renameBags(0, idOf);
+    }
+
+    // The other way round: every member x becomes its position in idOf.
+    void localize(const std::vector<int> &idOf) {
+        for (size_t b = 0; b < bag.size(); b++) {
+            std::set<int> renamed;
+            for (std::set<int>::const_iterator it = bag[b].begin(); it != bag[b].end(); it++)
+                renamed.insert(renamed.end(), CsrGraph::indexIn(idOf, *it));
+            bag[b].swap(renamed);
+        }
+    }
+
+    // Glues trees[a], a tree of atom a of split, into one tree: the bags of
+    // each tree follow those of the trees before it, and every link of split
+    // becomes an edge between a bag on either side that holds its separator.
+    void glueAtoms(const AtomDecomposition &split, const std::vector<const Tree *> &trees) {
+        std::vector<int> offset(trees.size());
+        for (size_t a = 0; a < trees.size(); a++) {
+            offset[a] = bag.size();
+            for (size_t e = 0; e < trees[a]->treeEdge.size(); e++)
+                treeEdge.push_back(
+                    std::make_pair(trees[a]->treeEdge[e].first + offset[a], trees[a]->treeEdge[e].second + offset[a]));
+            bag.insert(bag.end(), trees[a]->bag.begin(), trees[a]->bag.end());
+        }
+        numberOfBags = bag.size();
+        for (size_t l = 0; l < split.links.size(); l++) {
+            const AtomDecomposition::Link &link = split.links[l];
+            treeEdge.push_back(std::make_pair(offset[link.a] + trees[link.a]->holding(link.separator),
+                                              offset[link.b] + trees[link.b]->holding(link.separator)));
+        }
+    }
+
+    // Elimination ordering of nodes of width at most this tree's: each vertex
+    // goes by the first bag holding it in a breadth-first walk from bag 0,
+    // later bags first. Its neighbours left at that point all sit in that
+    // bag.
+    std::vector<int> eliminationOrdering(const std::vector<int> &nodes) const {
+        int bags = bag.size();
+        std::vector<std::vector<int>> next(bags);
+        for (size_t e = 0; e < treeEdge.size(); e++) {
+            next[treeEdge[e].first].push_back(treeEdge[e].second);
+            next[treeEdge[e].second].push_back(treeEdge[e].first);
+        }
+        std::vector<int> walk, rank(bags, -1);
+        for (int root = 0; root < bags; root++) {
+            if (rank[root] >= 0) continue;
+            rank[root] = walk.size();
+            walk.push_back(root);
+            for (size_t q = rank[root]; q < walk.size(); q++) {
+                for (size_t k = 0; k < next[walk[q]].size(); k++) {
+                    int b = next[walk[q]][k];
+                    if (rank[b] >= 0) continue;
+                    rank[b] = walk.size();
+                    walk.push_back(b);
+                }
+            }
+        }
+        std::map<int, int> top;
+        for (size_t q = 0; q < walk.size(); q++)
+            for (std::set<int>::const_iterator it = bag[walk[q]].begin(); it != bag[walk[q]].end(); it++)
+                top.insert(std::make_pair(*it, q));
+        std::vector<std::pair<int, int>> keyed;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            std::map<int, int>::const_iterator it = top.find(nodes[i]);
+            // in no bag: nothing to go by, so last
+            keyed.push_back(std::make_pair(it == top.end() ? 1 : -it->second, nodes[i]));
+        }
+        std::sort(keyed.begin(), keyed.end());
+        std::vector<int> ret;
+        for (size_t i = 0; i < keyed.size(); i++)
+            ret.push_back(keyed[i].second);
+        return ret;
+    }
+
+    // first bag that contains all of set, 0 if none does
+    int holding(const std::vector<int> &set) const {
+        for (size_t b = 0; b < bag.size(); b++) {
+            bool all = true;
+            for (size_t i = 0; i < set.size() && all; i++)
+                all = bag[b].count(set[i]) > 0;
+            if (all) return b;
+        }
+        return 0;
+    }
+
+   private:
+    // relabel from bag first on; idOf keeps the order, so every set is
+    // rebuilt in one pass
+    void renameBags(size_t first, const std::vector<int> &idOf) {
+        for (size_t b = first; b < bag.size(); b++) {
+            std::set<int> renamed;
+            for (std::set<int>::const_iterator it = bag[b].begin(); it != bag[b].end(); it++)
+                renamed.insert(renamed.end(), idOf[*it]);
+            bag[b].swap(renamed);
+        }
+    }
+};
+
+// Called with every decomposition of the whole graph that improves on the
+// last one reported; always on the thread that called runTreeWidth.
+typedef std::function<void(const Tree &)> ProgressFn;
+
+// Settings of a runTreeWidth call; every field may be left out on the JS side.
+struct RunOptions {
+    EliminationStrategy strategy;
+    // restart i of a run draws from seed_seq{seed, i}
+    unsigned int seed;
+    // restart workers, 0 = one per hardware thread
+    int threads;
+    // anytime mode, empty = only the final result
+    ProgressFn onProgress;
+    // time budget in milliseconds, 0 = none
+    double timeLimitMs;
+    // stop signal of the run, null = run to the end
+    CancelToken *cancel;
+    // per-phase times and per-restart counters, null = not collected
+    RunStats *stats;
+    // chordless cycles each kill_cycles round looks at, 0 = all
+    long long maxCycles;
+    // run the safe reduction rules first and only decompose what they leave
+    bool reduce;
+    // components of at most this many vertices (64 at most) are solved
+    // exactly instead of by restarts, 0 = never
+    int exactMaxVertices;
+    // what all exact solves of a run may take together (0 = no cap) and the
+    // memory one of them may use; past either the component falls back to
+    // the restarts
+    double exactTimeLimitMs;
+    long long exactMemoryBytes;
+    // split components along clique separators and solve the atoms apart
+    bool atoms;
+    // time the local search may take on each component after its restarts,
+    // 0 = no local search
+    double localSearchMs;
+    // best trees of earlier runs by content, of the whole graph and of every
+    // component; null = none. A complete entry is returned as is unless
+    // refineCached, which takes it as the tree to beat instead
+    DecompositionCache *cache;
+    bool refineCached;
+
+    RunOptions() {
+        strategy = CHORDLESS_CYCLES;
+        seed = 1;
+        threads = 0;
+        timeLimitMs = 0;
+        cancel = nullptr;
+        stats = nullptr;
+        maxCycles = 0;
+        reduce = true;
+        exactMaxVertices = 64;
+        exactTimeLimitMs = 1000;
+        exactMemoryBytes = 64 << 20;
+        atoms = true;
+        localSearchMs = 0;
+        cache = nullptr;
+        refineCached = false;
+    }
+};
+
+// The part of a cache key that comes from the settings which shape the
+// tree. A complete entry is what a full run with these settings ends with,
+// not with better ones; the seed, threads and time limit only decide which
+// of equally good trees comes out or whether the run completes.
+inline uint64_t settingsSalt(const RunOptions &options) {
+    uint64_t h = 0;
+    auto word = [&h](uint64_t x) {
+        h = (h ^ x) * 0x100000001b3ULL;
+        h ^= h >> 29;
+    };
+    word(options.strategy);
+    word(options.maxCycles);
+    word(options.reduce);
+    word(options.atoms);
+    word(std::min(options.exactMaxVertices, 64));
+    word((uint64_t)(options.exactTimeLimitMs * 1000));
+    word(options.exactMemoryBytes);
+    word((uint64_t)(options.localSearchMs * 1000));
+    return h;
+}
+
+// MIN_FILL decomposition of g: the tree restarts start from and the fallback
+// when none of them finished. MIN_FILL is O(n * fill), so it stops when
+// cancel fires, leaving the one-bag decomposition. MIN_DEGREE skips the fill
+// bookkeeping and is the quicker first answer of an anytime run.
+inline Tree *greedyTree(Graph &g, int numberOfVertices, CancelToken *cancel,
+                        EliminationStrategy strategy = MIN_FILL) {
+    Graph g2(g.base, g.nodes);
+    g2.interrupted = CancelCheck(cancel);
+    std::vector<int> peo = g2.triangulate(strategy);
+    Tree *tree = new Tree(numberOfVertices);
+    if (peo.empty() && !g.nodes.empty()) {
+        tree->bag.push_back(std::set<int>(g.nodes.begin(), g.nodes.end()));
+        tree->numberOfBags = 1;
+    } else {
+        tree->computeTreeDecomposition(peo, g2);
+    }
+    return tree;
+}
+
+// Replaces best by candidate unless candidate is wider; true when it was
+// narrower. Either way the caller no longer owns candidate.
+inline bool keepNarrower(Tree *&best, Tree *candidate) {
+    int width = best->getTreeWidthPlusOne(), other = candidate->getTreeWidthPlusOne();
+    if (other > width) {
+        delete candidate;
+        return false;
+    }
+    delete best;
+    best = candidate;
+    return other < width;
+}
+
+// Settles the component g exactly when it has at most
+// options.exactMaxVertices vertices and budget (the run's exact time cap)
+// has not fired. best is its tree so far, owned by the caller; it is
+// replaced when a narrower tree exists. Widths down to lowerBound count as
+// optimal, and lowerBound is raised by whatever widths the solve ruled out.
+// False, with best untouched, when g is too big or a cap ran out.
+inline bool solveExactly(Graph &g, int numberOfVertices, Tree *&best, int &lowerBound, const RunOptions &options,
+                         CancelToken &budget) {
+    if ((int)g.nodes.size() > std::min(options.exactMaxVertices, 64) || budget.check()) return false;
+    int high = best->getTreeWidthPlusOne() - 1;
+    if (high <= lowerBound) return true;
+    CancelCheck interrupted(&budget);
+    ExactTreewidth exact(g, g.nodes);
+    bool settled = exact.solve(lowerBound, high, options.exactMemoryBytes, &interrupted);
+    lowerBound = std::max(lowerBound, exact.lowerBound);
+    if (!settled) return false;
+    if (exact.ordering.empty()) return true;
+
+    Graph g2(g.base, g.nodes);
+    for (size_t i = 0; i < exact.fillEdges.size(); i++)
+        g2.fill.add(exact.fillEdges[i].first, exact.fillEdges[i].second);
+    Tree *tree = new Tree(numberOfVertices);
+    tree->computeTreeDecomposition(exact.ordering, g2);
+    delete best;
+    best = tree;
+    return true;
+}
+
+// Runs k independent restarts of g on a RestartPool and returns the tree of
+// minimum width, ties going to the lowest restart index. Workers share the
+// best width so far and drop a restart once one of its bags exceeds it; such
+// a restart can never win, so the result only depends on options.seed.
+//
+// incumbent (may be null) is a tree found beforehand; it counts as restart -1
+// and is owned by the call from then on. Each time the best tree improves,
+// onImprove (if set) gets a copy of it on the calling thread, between that
+// thread's own restarts.
+//
+// Once options.cancel fires, running restarts are dropped and the rest are
+// skipped; the best tree so far is returned, or the greedy tree if no
+// restart got through. Once the best tree has width lowerBound nothing can
+// beat it, so restarts above its index that have not started are skipped
+// too; the ones below might still tie and win, so they run. With
+// options.stats every restart that ran is recorded there, under component
+// and atom (see RestartStats).
+inline Tree *bestOfRestarts(Graph &g, int k, int numberOfVertices, const RunOptions &options, int lowerBound = 0,
+                            Tree *incumbent = nullptr, const ProgressFn &onImprove = ProgressFn(),
+                            int component = 0, int atom = 0) {
+    std::atomic<int> bound(std::numeric_limits<int>::max());
+    // index of the best tree once it meets lowerBound
+    std::atomic<int> optimalAt(std::numeric_limits<int>::max());
+    std::mutex bestLock;
+    Tree *bestTree = incumbent;
+    int bestTW = std::numeric_limits<int>::max();
+    int bestIndex = -1;
+    bool improved = false;
+    if (incumbent) {
+        bestTW = incumbent->getTreeWidthPlusOne();
+        bound.store(bestTW);
+        if (bestTW <= lowerBound + 1) optimalAt.store(-1);
+    }
+
+    std::thread::id caller = std::this_thread::get_id();
+    auto report = [&]() {
+        if (!onImprove) return;
+        Tree snapshot;
+        {
+            std::lock_guard<std::mutex> guard(bestLock);
+            if (!improved) return;
+            improved = false;
+            snapshot = *bestTree;
+        }
+        onImprove(snapshot);
+    };
+
+    RestartPool pool(options.threads);
+    pool.run(k, [&](int i) {
+        if (options.cancel && options.cancel->check()) return;
+        if (i > optimalAt.load(std::memory_order_relaxed)) return;
+        // cycle search scratch of this restart; g2 is gone before the next reset
+        Arena &arena = Arena::local();
+        arena.reset();
+        Graph g2(g.base, g.nodes);
+        g2.arena = &arena;
+        g2.maxCycles = options.maxCycles;
+        g2.reseed(options.seed, i);
+        g2.interrupted = CancelCheck(options.cancel);
+        RestartStats restart(component, atom, i);
+        RunStats::Clock::time_point phase;
+        if (options.stats) {
+            g2.stats = &restart;
+            phase = RunStats::Clock::now();
+        }
+        std::vector<int> peo = g2.triangulate(options.strategy);
+        if (options.stats) {
+            restart.triangulateMs = RunStats::msSince(phase);
+            restart.arenaBytes = arena.bytesUsed();
+            phase = RunStats::Clock::now();
+        }
+        if (peo.empty()) {
+            if (options.stats) options.stats->addRestart(restart);
+            return;
+        }
+
+        Tree *tree = new Tree(numberOfVertices);
+        bool complete = tree->computeTreeDecomposition(peo, g2, bound.load(std::memory_order_relaxed));
+        if (options.stats) {
+            restart.decomposeMs = RunStats::msSince(phase);
+            if (complete) restart.width = tree->getTreeWidthPlusOne() - 1;
+            options.stats->addRestart(restart);
+        }
+        if (complete) {
+            int tw = tree->getTreeWidthPlusOne();
+
+            std::lock_guard<std::mutex> guard(bestLock);
+            if (tw < bestTW || (tw == bestTW && i < bestIndex)) {
+                delete bestTree;
+                bestTree = tree;
+                // a tie on width is not worth reporting
+                improved = improved || tw < bestTW;
+                bestTW = tw;
+                bestIndex = i;
+                bound.store(tw, std::memory_order_relaxed);
+                if (tw <= lowerBound + 1) optimalAt.store(i, std::memory_order_relaxed);
+                tree = nullptr;
+            }
+        }
+        delete tree;
+        if (std::this_thread::get_id() == caller) report();
+    });
+    report();
+    if (!bestTree) bestTree = greedyTree(g, numberOfVertices, options.cancel);
+    return bestTree;
+}
+
+// Closes a stats phase under the given name; see decomposeKernel.
+typedef std::function<void(const char *)> PhaseFn;
+
+// Best tree of the connected graph g: settled by solveExactly when it
+// manages, by k restarts otherwise. incumbent (may be null, owned by the
+// call) is the tree to beat as for bestOfRestarts; when there is none and g
+// is small enough for the exact solve, the greedy tree of options.strategy
+// (MIN_FILL for CHORDLESS_CYCLES) stands in as its upper bound. endPhase, if
+// set, closes the "exact" and "restarts" phases.
+inline Tree *solvePiece(Graph &g, int k, int numberOfVertices, const RunOptions &options, int &lowerBound,
+                        CancelToken &exactBudget, Tree *incumbent, const ProgressFn &onImprove, int component,
+                        int atom, const PhaseFn &endPhase) {
+    if (!incumbent && !g.nodes.empty() && (int)g.nodes.size() <= std::min(options.exactMaxVertices, 64)) {
+        EliminationStrategy greedy = options.strategy == CHORDLESS_CYCLES ? MIN_FILL : options.strategy;
+        incumbent = greedyTree(g, numberOfVertices, options.cancel, greedy);
+    }
+    if (incumbent) {
+        Tree *before = incumbent;
+        bool settled = solveExactly(g, numberOfVertices, incumbent, lowerBound, options, exactBudget);
+        if (endPhase) endPhase("exact");
+        if (settled) {
+            if (incumbent != before && onImprove) onImprove(*incumbent);
+            return incumbent;
+        }
+    }
+    Tree *tree = bestOfRestarts(g, k, numberOfVertices, options, lowerBound, incumbent, onImprove, component, atom);
+    if (endPhase) endPhase("restarts");
+    return tree;
+}
+
+// Anneals the elimination ordering of tree, the best tree of the connected
+// graph g so far, for options.localSearchMs (see LocalSearch) and returns
+// the narrowest tree it finds, tree itself if none is narrower. onImprove
+// gets each narrower tree. Skipped once tree has width lowerBound or the run
+// is cancelled, and on graphs of fewer than 3 vertices, which have no
+// ordering to improve (an empty tree has no width at all).
+inline Tree *searchLocally(Graph &g, Tree *tree, int numberOfVertices, const RunOptions &options, int lowerBound,
+                           const ProgressFn &onImprove, int component, const PhaseFn &endPhase) {
+    if (options.localSearchMs <= 0 || g.nodes.size() < 3 || tree->bag.empty() ||
+        tree->getTreeWidthPlusOne() - 1 <= lowerBound ||
+        (options.cancel && options.cancel->check()))
+        return tree;
+    LocalSearch search(g, tree->eliminationOrdering(g.nodes));
+    Tree *best = tree;
+    std::seed_seq seq{options.seed, (unsigned int)component};
+    unsigned int seed;
+    seq.generate(&seed, &seed + 1);
+    search.run(options.localSearchMs, lowerBound, seed, options.cancel, [&]() {
+        if (search.bestWidth + 1 >= best->getTreeWidthPlusOne()) return;
+        Graph g2(g.base, g.nodes);
+        std::vector<std::pair<int, int>> fillEdges = search.fillEdges();
+        for (size_t i = 0; i < fillEdges.size(); i++)
+            g2.fill.add(fillEdges[i].first, fillEdges[i].second);
+        Tree *narrower = new Tree(numberOfVertices);
+        narrower->computeTreeDecomposition(search.best, g2);
+        delete best;
+        best = narrower;
+        if (onImprove) onImprove(*best);
+    });
+    if (endPhase) endPhase("localSearch");
+    return best;
+}
+
+// Best tree of the connected graph g, atom by atom when options.atoms finds
+// clique separators in it (see AtomDecomposition). Each atom starts from its
+// greedy tree when k > 1. All atoms but the largest are solved side by side,
+// one worker each; the largest follows with every worker, and the trees are
+// glued along the separators. onImprove gets the glued tree whenever it is
+// narrower than incumbent and everything reported before. The result then
+// goes through searchLocally. Otherwise as for solvePiece.
+inline Tree *solveComponent(Graph &g, int k, int numberOfVertices, const RunOptions &options, int &lowerBound,
+                            CancelToken &exactBudget, Tree *incumbent, const ProgressFn &onImprove, int component,
+                            const PhaseFn &endPhase) {
+    std::unique_ptr<AtomDecomposition> split;
+    if (options.atoms) {
+        split.reset(new AtomDecomposition(g, g.nodes));
+        if (endPhase) endPhase("atoms");
+    }
+    // a graph without vertices has no atoms at all
+    if (!split || split->atoms.size() <= 1) {
+        Tree *tree = solvePiece(g, k, numberOfVertices, options, lowerBound, exactBudget, incumbent, onImprove,
+                                component, 0, endPhase);
+        return searchLocally(g, tree, numberOfVertices, options, lowerBound, onImprove, component, endPhase);
+    }
+
+    const std::vector<std::vector<int>> &atoms = split->atoms;
+    int count = atoms.size();
+    int largest = 0;
+    for (int a = 1; a < count; a++)
+        if (atoms[a].size() > atoms[largest].size()) largest = a;
+
+    std::vector<const Tree *> trees(count, nullptr);
+    if (k > 1) {
+        for (int a = 0; a < count; a++) {
+            Graph piece = g.return_GK(atoms[a]);
+            Tree *tree = greedyTree(piece, atoms[a].size(), options.cancel);
+            tree->relabel(piece.base->idOf);
+            trees[a] = tree;
+        }
+        if (endPhase) endPhase("greedy");
+    }
+
+    // Glues and reports the trees when every atom has one and the result
+    // beats the last report; replacement, if set, stands in for trees[at].
+    // Only ever called on the calling thread.
+    std::mutex treesLock;
+    int reported = incumbent ? incumbent->getTreeWidthPlusOne() : std::numeric_limits<int>::max();
+    auto report = [&](int at, const Tree *replacement) {
+        if (!onImprove) return;
+        Tree glued(numberOfVertices);
+        {
+            std::lock_guard<std::mutex> guard(treesLock);
+            std::vector<const Tree *> current(trees);
+            if (replacement) current[at] = replacement;
+            int width = 0;
+            for (int a = 0; a < count; a++) {
+                if (!current[a]) return;
+                width = std::max(width, current[a]->getTreeWidthPlusOne());
+            }
+            if (width >= reported) return;
+            reported = width;
+            glued.glueAtoms(*split, current);
+        }
+        onImprove(glued);
+    };
+    report(-1, nullptr);
+
+    std::thread::id caller = std::this_thread::get_id();
+    RunOptions single = options;
+    single.threads = 1;
+    RestartPool pool(options.threads);
+    pool.run(count - 1, [&](int i) {
+        int a = i < largest ? i : i + 1;
+        Graph piece = g.return_GK(atoms[a]);
+        int bound;
+        {
+            std::lock_guard<std::mutex> guard(treesLock);
+            bound = lowerBound;
+        }
+        // only this task replaces trees[a], and report may read it meanwhile
+        Tree *start = trees[a] ? new Tree(*trees[a]) : nullptr;
+        if (start) start->localize(piece.base->idOf);
+        Tree *tree = solvePiece(piece, k, atoms[a].size(), single, bound, exactBudget, start, ProgressFn(),
+                                component, a + 1, PhaseFn());
+        tree->relabel(piece.base->idOf);
+        {
+            std::lock_guard<std::mutex> guard(treesLock);
+            delete trees[a];
+            trees[a] = tree;
+            lowerBound = std::max(lowerBound, bound);
+        }
+        if (std::this_thread::get_id() == caller) report(-1, nullptr);
+    });
+    report(-1, nullptr);
+
+    Graph piece = g.return_GK(atoms[largest]);
+    Tree *start = trees[largest] ? new Tree(*trees[largest]) : nullptr;
+    if (start) start->localize(piece.base->idOf);
+    ProgressFn onLargest;
+    if (onImprove) {
+        onLargest = [&](const Tree &tree) {
+            Tree named = tree;
+            named.relabel(piece.base->idOf);
+            report(largest, &named);
+        };
+    }
+    Tree *tree = solvePiece(piece, k, atoms[largest].size(), options, lowerBound, exactBudget, start, onLargest,
+                            component, largest + 1, PhaseFn());
+    tree->relabel(piece.base->idOf);
+    delete trees[largest];
+    trees[largest] = tree;
+    if (endPhase) endPhase("restarts");
+
+    Tree *glued = new Tree(numberOfVertices);
+    glued->glueAtoms(*split, trees);
+    for (int a = 0; a < count; a++)
+        delete trees[a];
+    if (endPhase) endPhase("glue");
+    if (incumbent && incumbent->getTreeWidthPlusOne() < glued->getTreeWidthPlusOne()) {
+        delete glued;
+        glued = incumbent;
+    } else {
+        delete incumbent;
+    }
+    return searchLocally(g, glued, numberOfVertices, options, lowerBound, onImprove, component, endPhase);
+}
+
+// Cache entry of tree, a decomposition of the graph whose dense ids names
+// maps to the caller's ids.
+inline DecompositionCache::Entry cacheEntry(const Tree &tree, const std::vector<int> &names, int lowerBound,
+                                            bool complete) {
+    DecompositionCache::Entry entry;
+    entry.width = tree.getTreeWidthPlusOne() - 1;
+    entry.lowerBound = lowerBound;
+    entry.complete = complete;
+    entry.bags.resize(tree.bag.size());
+    for (size_t b = 0; b < tree.bag.size(); b++)
+        for (std::set<int>::const_iterator it = tree.bag[b].begin(); it != tree.bag[b].end(); it++)
+            entry.bags[b].push_back(names[*it]);
+    entry.edges = tree.treeEdge;
+    return entry;
+}
+
+// The tree of a cache entry back over dense ids, null if it names a vertex
+// names does not have.
+inline Tree *cachedTree(const DecompositionCache::Entry &entry, const std::vector<int> &names,
+                        int numberOfVertices) {
+    Tree *tree = new Tree(numberOfVertices);
+    tree->bag.resize(entry.bags.size());
+    for (size_t b = 0; b < entry.bags.size(); b++) {
+        for (size_t i = 0; i < entry.bags[b].size(); i++) {
+            int v = CsrGraph::indexIn(names, entry.bags[b][i]);
+            if (v < 0) {
+                delete tree;
+                return nullptr;
+            }
+            tree->bag[b].insert(v);
+        }
+    }
+    tree->numberOfBags = tree->bag.size();
+    tree->treeEdge = entry.edges;
+    tree->lowerBound = entry.lowerBound;
+    return tree;
+}
+
+// solveComponent behind options.cache, keyed by the component in the
+// caller's ids (names maps dense ids to them) and the settings. A cached
+// tree narrower than incumbent replaces it and is reported; a complete one
+// is the answer unless options.refineCached. The result goes back in with
+// the component's own lower bound: lowerBound is one for the whole graph.
+inline Tree *solveCached(Graph &g, int k, int numberOfVertices, const RunOptions &options, int &lowerBound,
+                         CancelToken &exactBudget, Tree *incumbent, const ProgressFn &onImprove, int component,
+                         const PhaseFn &endPhase, const std::vector<int> &names) {
+    DecompositionCache *cache = options.cache;
+    if (!cache || (int)g.nodes.size() < DecompositionCache::MIN_VERTICES)
+        return solveComponent(g, k, numberOfVertices, options, lowerBound, exactBudget, incumbent, onImprove,
+                              component, endPhase);
+
+    uint64_t key = graphKey(*g.base, g.nodes, names, settingsSalt(options));
+    DecompositionCache::Entry entry;
+    Tree *cached = cache->lookup(key, entry) ? cachedTree(entry, names, numberOfVertices) : nullptr;
+    if (options.stats) (cached ? options.stats->cacheHits : options.stats->cacheMisses)++;
+    if (cached) {
+        lowerBound = std::max(lowerBound, entry.lowerBound);
+        if (!incumbent || cached->getTreeWidthPlusOne() < incumbent->getTreeWidthPlusOne()) {
+            delete incumbent;
+            incumbent = cached;
+            if (onImprove) onImprove(*incumbent);
+        } else {
+            delete cached;
+        }
+        if (endPhase) endPhase("cache");
+        if (entry.complete && !options.refineCached) return incumbent;
+    }
+
+    Tree *tree = solveComponent(g, k, numberOfVertices, options, lowerBound, exactBudget, incumbent, onImprove,
+                                component, endPhase);
+    int own = LowerBound::best(g, g.nodes);
+    bool complete = !(options.cancel && options.cancel->cancelled()) || tree->getTreeWidthPlusOne() - 1 <= own;
+    cache->store(key, cacheEntry(*tree, names, own, complete));
+    if (endPhase) endPhase("cache");
+    return tree;
+}
+
+// The component and restart scheme behind decompose, on the graph that is
+// left once the reduction rules are done with it. lowerBound comes in as
+// what is known about the width already and goes out raised to the best
+// bound on csr; restarts stop early once they reach it. names maps the
+// dense ids of csr to the caller's ids, for options.cache.
+inline Tree *decomposeKernel(std::shared_ptr<const CsrGraph> csr, const RunOptions &options, int &lowerBound,
+                             const std::vector<int> &names) {
+    // with options.stats, adds the time since start to the named phase
+    RunStats::Clock::time_point start = RunStats::Clock::now();
+    auto endPhase = [&](const char *name) {
+        if (!options.stats) return;
+        options.stats->addPhase(name, RunStats::msSince(start));
+        start = RunStats::Clock::now();
+    };
+
+    int total_nodes = csr->n;
+    Graph g(csr);
+
+    // Run DFS to mark connected components and detect cycles.
+    g.DFS();
+    endPhase("DFS");
+
+    // the width is the largest over the components, so one bound for the
+    // whole graph serves every one of them
+    lowerBound = std::max(lowerBound, LowerBound::best(g, g.nodes));
+    endPhase("bounds");
+
+    // one time cap for all exact solves, which a cancel of the run also ends
+    CancelToken exactBudget;
+    if (options.exactTimeLimitMs > 0) exactBudget.setTimeLimit(options.exactTimeLimitMs);
+    exactBudget.setPoll([&options]() { return options.cancel && options.cancel->check(); });
+
+    // Determine iteration count based on whether a cycle was found.
+    // The greedy strategies are deterministic, so one run is enough.
+    int k = (g.cycle_found && options.strategy == CHORDLESS_CYCLES) ? 1000 : 1;
+    Tree *resultTree = nullptr;
+
+    // Case 1: Single cycle graph.
+    if (total_nodes == (int)csr->edgeCount() && g.no_of_components == 1) {
+        // one restart, so it honours options.cancel like the others
+        resultTree = bestOfRestarts(g, 1, total_nodes, options, lowerBound);
+        endPhase("restarts");
+    }
+    // Case 2: Graph with multiple connected components.
+    else if (g.no_of_components > 1) {
+        k = (options.strategy == CHORDLESS_CYCLES) ? 50 : 1;  // Use fewer iterations per component.
+        std::vector<Tree *> component_trees(g.no_of_components, nullptr);
+
+        // Every component is cut out once, over ids of its own; its tree
+        // keeps those, and partIds maps them back when the trees are joined.
+        std::vector<std::shared_ptr<const CsrGraph>> parts(g.no_of_components);
+        std::vector<const std::vector<int> *> partIds(g.no_of_components);
+        for (int comp = 1; comp <= g.no_of_components; comp++) {
+            parts[comp - 1] = g.return_GK(g.components[comp - 1]).base;
+            partIds[comp - 1] = &parts[comp - 1]->idOf;
+        }
+
+        // anytime: start every component from its greedy trees, the
+        // MIN_DEGREE ones reported before MIN_FILL runs, and report the
+        // whole graph again whenever one component improves
+        if (k > 1) {
+            auto reportAll = [&]() {
+                if (!options.onProgress) return;
+                Tree bigTree(total_nodes);
+                bigTree.computeBigTree(component_trees, partIds);
+                options.onProgress(bigTree);
+            };
+            for (int comp = 1; comp <= g.no_of_components; comp++) {
+                Graph curr_comp(parts[comp - 1]);
+                component_trees[comp - 1] =
+                    greedyTree(curr_comp, curr_comp.nodes.size(), options.cancel, MIN_DEGREE);
+            }
+            reportAll();
+            bool improved = false;
+            for (int comp = 1; comp <= g.no_of_components; comp++) {
+                Graph curr_comp(parts[comp - 1]);
+                improved |= keepNarrower(component_trees[comp - 1],
+                                         greedyTree(curr_comp, curr_comp.nodes.size(), options.cancel));
+            }
+            endPhase("greedy");
+            if (improved) reportAll();
+        }
+
+        std::vector<int> partNames;
+        for (int comp = 1; comp <= g.no_of_components; comp++) {
+            Graph curr_comp(parts[comp - 1]);
+            int curr_nodes_size = curr_comp.nodes.size();
+
+            ProgressFn onImprove;
+            if (options.onProgress) {
+                onImprove = [&, comp](const Tree &compTree) {
+                    Tree improved = compTree;
+                    std::vector<Tree *> current = component_trees;
+                    current[comp - 1] = &improved;
+                    Tree bigTree(total_nodes);
+                    bigTree.computeBigTree(current, partIds);
+                    options.onProgress(bigTree);
+                };
+            }
+            // the cache keys components by the caller's ids
+            partNames.clear();
+            if (options.cache) {
+                for (int i = 0; i < curr_nodes_size; i++)
+                    partNames.push_back(names[(*partIds[comp - 1])[i]]);
+            }
+            component_trees[comp - 1] = solveCached(curr_comp, k, curr_nodes_size, options, lowerBound,
+                                                    exactBudget, component_trees[comp - 1], onImprove, comp,
+                                                    endPhase, partNames);
+        }
+        // Combine the trees from all connected components into one.
+        Tree *bigTree = new Tree(total_nodes);
+        bigTree->computeBigTree(component_trees, partIds);
+        resultTree = bigTree;
+        for (size_t i = 0; i < component_trees.size(); i++)
+            delete component_trees[i];
+        endPhase("glue");
+    }
+    // Case 3: Single connected component (not just a cycle)
+    else {
+        // anytime: the MIN_DEGREE tree is the first answer, then the
+        // narrower of it and the MIN_FILL one is the bar the restarts have
+        // to beat
+        Tree *incumbent = nullptr;
+        if (k > 1) {
+            incumbent = greedyTree(g, total_nodes, options.cancel, MIN_DEGREE);
+            if (options.onProgress) options.onProgress(*incumbent);
+            bool improved = keepNarrower(incumbent, greedyTree(g, total_nodes, options.cancel));
+            endPhase("greedy");
+            if (improved && options.onProgress) options.onProgress(*incumbent);
+        }
+        // not solveCached: decompose has looked the whole graph up already
+        resultTree = solveComponent(g, k, total_nodes, options, lowerBound, exactBudget, incumbent,
+                                    options.onProgress, 0, endPhase);
+    }
+
+    return resultTree;
+}
+
+// Tree decomposition of the whole graph csr, for runTreeWidth and the
+// command line. Unless options.reduce is off the reduction rules shrink the
+// graph first, decomposeKernel solves the kernel and every tree it returns
+// or reports is lifted back to csr. Trees carry the best lower bound found on
+// the way. The caller owns the returned tree; its bags hold dense ids
+// (csr->idOf maps them back).
+//
+// With options.cache the whole graph is looked up first, under the settings
+// (see settingsSalt): a complete entry is the answer unless
+// options.refineCached, any other is reported and kept if the run does no
+// better. The result goes back in, complete unless the run was cut short
+// above its lower bound.
+inline Tree *decompose(std::shared_ptr<const CsrGraph> csr, const RunOptions &options) {
+    RunStats::Clock::time_point start = RunStats::Clock::now();
+    std::unique_ptr<GraphReduction> reduction;
+    int lowerBound = 0;
+
+    bool cached = options.cache && csr->n >= DecompositionCache::MIN_VERTICES;
+    uint64_t key = 0;
+    DecompositionCache::Entry entry;
+    std::unique_ptr<Tree> hit;
+    if (cached) {
+        std::vector<int> all(csr->n);
+        for (int v = 0; v < csr->n; v++)
+            all[v] = v;
+        key = graphKey(*csr, all, csr->idOf, settingsSalt(options));
+        if (options.cache->lookup(key, entry)) hit.reset(cachedTree(entry, csr->idOf, csr->n));
+        if (options.stats) {
+            (hit ? options.stats->cacheHits : options.stats->cacheMisses)++;
+            options.stats->addPhase("cache", RunStats::msSince(start));
+        }
+        if (hit && entry.complete && !options.refineCached) return hit.release();
+        if (hit) {
+            lowerBound = entry.lowerBound;
+            if (options.onProgress) options.onProgress(*hit);
+        }
+        start = RunStats::Clock::now();
+    }
+
+    if (options.reduce) {
+        reduction.reset(new GraphReduction(*csr));
+        lowerBound = std::max(lowerBound, reduction->lowerBound);
+        if (options.stats) {
+            options.stats->addPhase("reduce", RunStats::msSince(start));
+            options.stats->kernelVertices = reduction->kernel->n;
+            options.stats->kernelEdges = reduction->kernel->edgeCount();
+        }
+        if (reduction->removedCount() == 0) reduction.reset();
+    }
+
+    // a tree of csr from one of the kernel
+    auto finish = [&](const Tree &kernelTree) {
+        Tree *tree = new Tree(csr->n);
+        if (reduction) {
+            reduction->lift(kernelTree.bag, kernelTree.treeEdge, tree->bag, tree->treeEdge);
+            tree->numberOfBags = tree->bag.size();
+        } else {
+            *tree = kernelTree;
+        }
+        tree->lowerBound = lowerBound;
+        return tree;
+    };
+    RunOptions kernelOptions = options;
+    if (options.onProgress) {
+        kernelOptions.onProgress = [&](const Tree &kernelTree) {
+            Tree *tree = finish(kernelTree);
+            options.onProgress(*tree);
+            delete tree;
+        };
+    }
+    // the caller's ids of the kernel's vertices, for the component keys
+    std::vector<int> names;
+    if (options.cache && reduction) {
+        names.resize(reduction->kernel->n);
+        for (int v = 0; v < reduction->kernel->n; v++)
+            names[v] = csr->idOf[reduction->kernel->idOf[v]];
+    }
+    Tree *kernelTree = nullptr;
+    if (reduction && reduction->kernel->n == 0)
+        kernelTree = new Tree(0);
+    else
+        kernelTree = decomposeKernel(reduction ? reduction->kernel : csr, kernelOptions, lowerBound,
+                                     reduction ? names : csr->idOf);
+
+    start = RunStats::Clock::now();
+    Tree *tree = finish(*kernelTree);
+    delete kernelTree;
+    if (options.stats && reduction) options.stats->addPhase("lift", RunStats::msSince(start));
+    if (!cached) return tree;
+
+    start = RunStats::Clock::now();
+    if (hit && hit->getTreeWidthPlusOne() < tree->getTreeWidthPlusOne()) {
+        hit->lowerBound = tree->lowerBound;
+        delete tree;
+        tree = hit.release();
+    }
+    // a cut short run is still complete when it reached the lower bound
+    bool complete = !(options.cancel && options.cancel->cancelled()) ||
+                    tree->getTreeWidthPlusOne() - 1 <= tree->lowerBound;
+    options.cache->store(key, cacheEntry(*tree, csr->idOf, tree->lowerBound, complete));
+    if (options.stats) options.stats->addPhase("cache", RunStats::msSince(start));
+    return tree;
+}
+
+#endif
@@ -39,7 +39,10 @@ import {
 } from "~/components/ui/select";
 import { populateGraphData } from "~/data/dataPopulation";
 import { useToast } from "~/hooks/use-toast";
-import { useWorker } from "../algorithm-runner/context/WorkerContext";
+import {
+	terminateWorker,
+	useWorker,
+} from "../algorithm-runner/context/WorkerContext";
 
 export default function SVGEditor({
 	defaultRawData,
@@ -116,7 +119,7 @@ export default function SVGEditor({
 		});
 		setRawData(selectedGraphData);
 		setSampleGraphSelectValue(val);
-		workerRef.current?.terminate();
+		terminateWorker(workerRef);
 		dispatch(runnerSlice.actions.setIsRunning(false));
 		dispatch(editorSlice.actions.setHighlightedElement(null));
 	};
@@ -137,7 +140,7 @@ export default function SVGEditor({
 		// reset selection box if needed
 		setSampleGraphSelectValueKey(+new Date());
 		setSampleGraphSelectValue(undefined);
-		workerRef.current?.terminate();
+		terminateWorker(workerRef);
 		dispatch(runnerSlice.actions.setIsRunning(false));
 		toast({
 			title: `Graph editor reset!`,
@@ -608,7 +611,7 @@ export default function SVGEditor({
 		setSampleGraphSelectValueKey(+new Date());
 		setSampleGraphSelectValue(undefined);
 		renderGraph();
-		workerRef.current?.terminate();
+		terminateWorker(workerRef);
 		dispatch(runnerSlice.actions.setIsRunning(false));
 		setIsUploadFileValid(false);
 		toast({
@@ -1,26 +1,255 @@
 import createTreeWidthAlgoModule from "../../app/modules/algorithm-runner/wasm/treeWidthAlgo";
 
+// results come back as Int32Arrays with buffers of their own (see
+// decompositionToFlat); hand those over instead of cloning them
+const transferList = (res) => [
+	res.bagOffsets.buffer,
+	res.bagMembers.buffer,
+	res.treeEdges.buffer,
+];
+
+// One module instance per worker, created by the first run and reused by
+// every later one; restarts reuse their arenas inside it, so the heap stops
+// growing once the largest graph has been seen.
+let modulePromise = null;
+
+// Persistent side of the module's decomposition cache: entries live in
+// IndexedDB, but the module reads them synchronously, so they are all loaded
+// into a Map when the worker starts and every store goes to both. Without
+// IndexedDB the Map alone keeps them for the worker's lifetime.
+const openCacheBackend = () =>
+	new Promise((resolve) => {
+		const entries = new Map();
+		const memoryOnly = {
+			load: (key) => entries.get(key),
+			store: (key, data) => entries.set(key, data),
+		};
+		if (typeof indexedDB === "undefined") {
+			resolve(memoryOnly);
+			return;
+		}
+		const request = indexedDB.open("treewidth-cache", 1);
+		request.onupgradeneeded = () => request.result.createObjectStore("decompositions");
+		request.onerror = () => resolve(memoryOnly);
+		request.onsuccess = () => {
+			const db = request.result;
+			const cursor = db.transaction("decompositions").objectStore("decompositions").openCursor();
+			cursor.onsuccess = () => {
+				const at = cursor.result;
+				if (at) {
+					entries.set(at.key, at.value);
+					at.continue();
+					return;
+				}
+				resolve({
+					load: (key) => entries.get(key),
+					store: (key, data) => {
+						entries.set(key, data);
+						db.transaction("decompositions", "readwrite").objectStore("decompositions").put(data, key);
+					},
+				});
+			};
+			cursor.onerror = () => resolve(memoryOnly);
+		};
+	});
+
+// What this worker calls. treeWidthAlgo.js and .wasm are checked in, so a
+// copy built from older sources loads fine and only fails on first use;
+// say which build is stale instead.
+const requiredExports = ["runTreeWidthTyped", "DecompositionSession", "EliminationStrategy"];
+
+// False once the decomposition cache could not be set up; runs then go
+// without it rather than not at all.
+let cacheAvailable = true;
+
+const loadModule = () =>
+	createTreeWidthAlgoModule().then((module) => {
+		const missing = requiredExports.filter((name) => !(name in module));
+		if (missing.length > 0) {
+			throw new Error(
+				`treeWidthAlgo.wasm predates ${missing.join(", ")}; rebuild it with pnpm run build:wasm`
+			);
+		}
+		return openCacheBackend()
+			.then((backend) => module.setCacheBackend(backend))
+			.catch((e) => {
+				console.log("decomposition cache unavailable, running without it", e);
+				cacheAvailable = false;
+			})
+			.then(() => module);
+	});
+
+// The graph of the last run, held by a DecompositionSession: the next run
+// hands it only what the editor changed since, and only the components an
+// edit touched are decomposed again. Other settings start a new session.
+let session = null;
+let sessionKey = "";
+let sessionVertices = new Set();
+let sessionEdges = new Set();
+
+const edgeKey = (u, v) => (u < v ? `${u},${v}` : `${v},${u}`);
+
+// ends a run that has no result, so the page stops waiting for one
+const postError = (e) => {
+	console.log(e);
+	postMessage({
+		type: "ERROR",
+		payload: {
+			message: String(e?.message ?? e),
+		},
+	});
+};
+
+// brings the session up to the editor's graph one vertex or edge at a time
+const syncSession = (DecompositionSession, key, storedVertices, storedEdges) => {
+	if (!session || key !== sessionKey) {
+		session?.delete();
+		session = new DecompositionSession();
+		sessionKey = key;
+		sessionVertices = new Set();
+		sessionEdges = new Set();
+	}
+	const vertices = new Set(storedVertices.map((v) => v.id));
+	const edges = new Map();
+	storedEdges.forEach((e) => edges.set(edgeKey(e.uId, e.vId), e));
+
+	sessionEdges.forEach((k) => {
+		if (edges.has(k)) return;
+		const [u, v] = k.split(",").map(Number);
+		session.removeEdge(u, v);
+	});
+	sessionVertices.forEach((id) => {
+		if (!vertices.has(id)) session.removeVertex(id);
+	});
+	vertices.forEach((id) => {
+		if (!sessionVertices.has(id)) session.addVertex(id);
+	});
+	edges.forEach((e, k) => {
+		if (!sessionEdges.has(k)) session.addEdge(e.uId, e.vId);
+	});
+	sessionVertices = vertices;
+	sessionEdges = new Set(edges.keys());
+};
+
 onmessage = function (msg) {
 	if (msg.data.type === "RUN_TREE_WIDTH") {
-		createTreeWidthAlgoModule().then(({ runTreeWidth }) => {
-			const { storedVertices, storedEdges } = msg.data.payload;
-			const totalNodes = storedVertices.length;
-			const totalEdges = storedEdges.length;
-			const nodes = storedVertices.map((v) => v.id);
-			const edges = storedEdges.map((e) => e.id);
+		// a failed load is not kept: the next run tries again
+		modulePromise ??= loadModule().catch((e) => {
+			modulePromise = null;
+			throw e;
+		});
+		modulePromise.then(({ runTreeWidthTyped, DecompositionSession, EliminationStrategy }) => {
+			const {
+				storedVertices,
+				storedEdges,
+				strategy,
+				seed,
+				threads,
+				timeLimitMs,
+				maxCycles,
+				reduce,
+				atoms,
+				exactMaxVertices,
+				exactTimeLimitMs,
+				exactMemoryBytes,
+				localSearchMs,
+				incremental,
+				cache,
+				refineCached,
+				cancelFlag,
+				stats,
+			} = msg.data.payload;
 
 			try {
-				const res = runTreeWidth(totalNodes, totalEdges, nodes, edges);
+				// everything the trees a session keeps depend on
+				const settings = {
+					// CHORDLESS_CYCLES, MIN_DEGREE, MIN_FILL or MIN_WIDTH
+					strategy: EliminationStrategy[strategy ?? "CHORDLESS_CYCLES"],
+					// same seed, same decomposition
+					seed: seed ?? 1,
+					// chordless cycles each restart breaks, 0 = all
+					maxCycles: maxCycles ?? 0,
+					// safe reduction rules before the restarts
+					reduce: reduce ?? true,
+					// split components along clique separators and solve the
+					// pieces in parallel
+					atoms: atoms ?? true,
+					// components up to this size are solved exactly (at most
+					// 64, 0 = never) within a shared time cap and a memory cap
+					// per solve, falling back to the restarts past either
+					exactMaxVertices: exactMaxVertices ?? 64,
+					exactTimeLimitMs: exactTimeLimitMs ?? 1000,
+					exactMemoryBytes: exactMemoryBytes ?? 64 * 1024 * 1024,
+					// time to anneal the elimination ordering of each
+					// component the restarts left above its lower bound, 0 =
+					// none
+					localSearchMs: localSearchMs ?? 500,
+					// reuse the best trees earlier runs found for the graph or
+					// any of its components, kept across reloads in IndexedDB;
+					// refineCached keeps improving them instead of returning
+					// them as they are
+					cache: cacheAvailable && (cache ?? true),
+					refineCached: refineCached ?? false,
+				};
+				const options = {
+					...settings,
+					// restart threads, 0 = navigator.hardwareConcurrency
+					threads: threads ?? 0,
+					// time budget in ms, 0 = none
+					timeLimitMs: timeLimitMs ?? 0,
+					// Int32Array over a SharedArrayBuffer, non-zero = stop
+					// and return the best decomposition so far
+					cancelFlag: cancelFlag,
+					// res.stats: phase times, per-restart counters and
+					// peakHeapBytes
+					stats: stats ?? false,
+					// anytime mode: forward every improved decomposition
+					onProgress: (progress) => {
+						postMessage(
+							{
+								type: "PROGRESS",
+								payload: {
+									res: progress,
+								},
+							},
+							transferList(progress)
+						);
+					},
+				};
+
+				let res;
+				// the session by default; incremental: false runs the whole
+				// graph from scratch
+				if (incremental ?? true) {
+					// an embind enum value stringifies to {}, so the key
+					// names the strategy
+					const key = JSON.stringify({ ...settings, strategy: strategy ?? "CHORDLESS_CYCLES" });
+					syncSession(DecompositionSession, key, storedVertices, storedEdges);
+					res = session.decompose(options);
+				} else {
+					// vertex ids and edge endpoint pairs (u0, v0, u1, v1,
+					// ...), each copied into wasm memory in one block
+					const nodes = Int32Array.from(storedVertices, (v) => v.id);
+					const edges = new Int32Array(2 * storedEdges.length);
+					storedEdges.forEach((e, i) => {
+						edges[2 * i] = e.uId;
+						edges[2 * i + 1] = e.vId;
+					});
+					res = runTreeWidthTyped(nodes, edges, options);
+				}
 				// console.log("res in worker", res);
-				postMessage({
-					type: "RESULT",
-					payload: {
-						res: res,
+				postMessage(
+					{
+						type: "RESULT",
+						payload: {
+							res: res,
+						},
 					},
-				});
+					transferList(res)
+				);
 			} catch (e) {
-				console.log(e);
+				postError(e);
 			}
-		});
+		}).catch(postError);
 	}
 };